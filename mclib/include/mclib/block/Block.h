@@ -87,27 +87,44 @@ public:
 };
 typedef Block* BlockPtr;
 
+/**
+ * Owns every block state of the current protocol version.
+ * Besides the Block objects, the registry keeps dense tables indexed by state id so hot queries
+ * like IsSolid are an array lookup instead of a hash lookup and a pointer chase.
+ */
 class BlockRegistry {
 private:
     std::unordered_map<u32, BlockPtr> m_Blocks;
     std::unordered_map<std::string, BlockPtr> m_BlockNames;
 
-    BlockRegistry() { }
+    // Indexed by state id. Null for ids that aren't registered.
+    std::vector<BlockPtr> m_States;
+    // One bit per state id. Ids that aren't registered use their base id, the same as GetBlock.
+    // Sized to a multiple of 16 so the metas after the last registered id are covered too.
+    std::vector<u64> m_SolidStates;
+    std::vector<u64> m_OpaqueStates;
+    // Solid blocks and fluids, the blocks of the MOTION_BLOCKING heightmap.
+    std::vector<u64> m_MotionBlockingStates;
+    // Index into m_Shapes for each state id. Shape 0 is the empty box.
+    std::vector<u16> m_ShapeIndices;
+    std::vector<AABB> m_Shapes;
+
+    MCLIB_API BlockRegistry();
+
+    void SetStateProperties(u32 data, BlockPtr block);
+    u16 GetShapeIndex(const AABB& bounds);
+
 public:
     static MCLIB_API BlockRegistry* GetInstance();
 
     MCLIB_API ~BlockRegistry();
 
-    BlockPtr GetBlock(u32 data) const {
-        auto iter = m_Blocks.find(data);
+    BlockPtr GetBlock(u32 data) const noexcept {
+        if (data < m_States.size() && m_States[data] != nullptr)
+            return m_States[data];
 
-        if (iter == m_Blocks.end()) {
-            data &= ~15; // Return basic version if the meta type can't be found
-            iter = m_Blocks.find(data);
-            if (iter == m_Blocks.end())
-                return nullptr;
-        }
-        return iter->second;
+        data &= ~15; // Return basic version if the meta type can't be found
+        return data < m_States.size() ? m_States[data] : nullptr;
     }
 
     BlockPtr GetBlock(u16 type, u16 meta) const {
@@ -117,15 +134,39 @@ public:
 
     BlockPtr MCLIB_API GetBlock(const std::string& name) const;
 
-    void RegisterBlock(BlockPtr block) {
-        m_Blocks[block->GetType()] = block;
-        m_BlockNames[block->GetName()] = block;
+    bool IsSolid(u32 data) const noexcept {
+        return (data >> 6) < m_SolidStates.size() && ((m_SolidStates[data >> 6] >> (data & 63)) & 1) != 0;
+    }
+
+    bool IsOpaque(u32 data) const noexcept {
+        return (data >> 6) < m_OpaqueStates.size() && ((m_OpaqueStates[data >> 6] >> (data & 63)) & 1) != 0;
+    }
+
+    // Solid or a fluid. The flattened tables don't count water as solid, but it still blocks motion.
+    bool IsMotionBlocking(u32 data) const noexcept {
+        return (data >> 6) < m_MotionBlockingStates.size() && ((m_MotionBlockingStates[data >> 6] >> (data & 63)) & 1) != 0;
     }
 
+    // Blocks with the same bounding box share a shape index.
+    u16 GetShapeIndex(u32 data) const noexcept {
+        return data < m_ShapeIndices.size() ? m_ShapeIndices[data] : 0;
+    }
+
+    const AABB& GetShape(u16 index) const noexcept {
+        return m_Shapes[index];
+    }
+
+    std::size_t GetShapeCount() const noexcept { return m_Shapes.size(); }
+
+    void MCLIB_API RegisterBlock(BlockPtr block);
+
 	const std::unordered_map<u32, BlockPtr>& getBlocks(){
 		return m_Blocks;
 	}
 
+    // Rebuilds the state tables. Has to be called after changing blocks that are already registered.
+    void MCLIB_API UpdateTables();
+
     void MCLIB_API RegisterVanillaBlocks(protocol::Version protocolVersion);
     void MCLIB_API ClearRegistry();
 };
@@ -0,0 +1,18 @@
+#ifndef MCLIB_COMMON_BYTE_SWAP_H_
+#define MCLIB_COMMON_BYTE_SWAP_H_
+
+#include <mclib/mclib.h>
+#include <mclib/common/Types.h>
+
+namespace mc {
+
+/**
+ * Reverses the byte order of count elements of elementSize bytes each, in place.
+ * elementSize has to be 1, 2, 4 or 8. data doesn't have to be aligned.
+ * Uses AVX2 or SSSE3 shuffles when the CPU supports them.
+ */
+MCLIB_API void ByteSwapArray(void* data, std::size_t count, std::size_t elementSize) noexcept;
+
+} // ns mc
+
+#endif
@@ -2,10 +2,12 @@
 #define MCLIB_COMMON_DATA_BUFFER_H_
 
 #include <mclib/common/Common.h>
+#include <mclib/common/ByteSwap.h>
 #include <vector>
 #include <algorithm>
 #include <cstring>
 #include <cassert>
+#include <type_traits>
 
 namespace mc {
 
@@ -87,6 +89,20 @@ public:
         return *this;
     }
 
+    // Reads count big endian values at once. Much faster than reading large arrays one value at a time.
+    template <typename T>
+    void ReadBigEndianArray(T* out, std::size_t count) {
+        static_assert(std::is_arithmetic<T>::value, "DataBuffer can only read arrays of primitive types.");
+
+        std::size_t size = count * sizeof(T);
+        assert(m_ReadOffset + size <= GetSize());
+        if (size == 0) return;
+
+        memcpy(out, &m_Buffer[m_ReadOffset], size);
+        ByteSwapArray(out, count, sizeof(T));
+        m_ReadOffset += size;
+    }
+
     void ReadSome(char* buffer, std::size_t amount) {
         assert(m_ReadOffset + amount <= GetSize());
         std::copy_n(m_Buffer.begin() + m_ReadOffset, amount, buffer);
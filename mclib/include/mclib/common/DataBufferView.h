@@ -0,0 +1,102 @@
+#ifndef MCLIB_COMMON_DATA_BUFFER_VIEW_H_
+#define MCLIB_COMMON_DATA_BUFFER_VIEW_H_
+
+#include <mclib/common/Common.h>
+#include <mclib/common/DataBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace mc {
+
+/**
+ * Non-owning view of a byte range with a read cursor.
+ * Reads the same big endian data as DataBuffer without copying it first.
+ * Every read is bounds checked and throws std::out_of_range when it runs past the end.
+ * The viewed memory must stay alive and unchanged while the view is used.
+ */
+class DataBufferView {
+private:
+    const u8* m_Data;
+    std::size_t m_Size;
+    std::size_t m_ReadOffset;
+
+    void Require(std::size_t amount) const {
+        if (amount > m_Size - m_ReadOffset)
+            throw std::out_of_range("Failed reading past the end of DataBufferView.");
+    }
+
+public:
+    DataBufferView() noexcept : m_Data(nullptr), m_Size(0), m_ReadOffset(0) { }
+    DataBufferView(const u8* data, std::size_t size) noexcept : m_Data(data), m_Size(size), m_ReadOffset(0) { }
+    // Views the whole buffer, starting at its current read offset.
+    explicit DataBufferView(const DataBuffer& buffer) noexcept
+        : m_Data(buffer.IsEmpty() ? nullptr : &buffer[0]),
+          m_Size(buffer.GetSize()),
+          m_ReadOffset(buffer.GetReadOffset())
+    {
+    }
+
+    template <typename T>
+    DataBufferView& operator>>(T& data) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "DataBufferView can only read primitive types directly.");
+
+        Require(sizeof(T));
+        memcpy(&data, m_Data + m_ReadOffset, sizeof(T));
+        // Switch from big endian
+        std::reverse((u8*)&data, (u8*)&data + sizeof(T));
+        m_ReadOffset += sizeof(T);
+        return *this;
+    }
+
+    void ReadSome(u8* buffer, std::size_t amount) {
+        Require(amount);
+        std::copy_n(m_Data + m_ReadOffset, amount, buffer);
+        m_ReadOffset += amount;
+    }
+
+    void ReadSome(DataBuffer& buffer, std::size_t amount) {
+        Require(amount);
+        buffer.Resize(amount);
+        buffer.SetReadOffset(0);
+        std::copy_n(m_Data + m_ReadOffset, amount, buffer.begin());
+        m_ReadOffset += amount;
+    }
+
+    void ReadSome(std::string& buffer, std::size_t amount) {
+        Require(amount);
+        buffer.assign((const char*)m_Data + m_ReadOffset, amount);
+        m_ReadOffset += amount;
+    }
+
+    // Points view at the next amount bytes without copying them.
+    void ReadSome(DataBufferView& view, std::size_t amount) {
+        Require(amount);
+        view = DataBufferView(m_Data + m_ReadOffset, amount);
+        m_ReadOffset += amount;
+    }
+
+    const u8* GetData() const noexcept { return m_Data; }
+    const u8* GetReadPointer() const noexcept { return m_Data + m_ReadOffset; }
+
+    std::size_t GetSize() const noexcept { return m_Size; }
+    std::size_t GetRemaining() const noexcept { return m_Size - m_ReadOffset; }
+    bool IsEmpty() const noexcept { return m_Size == 0; }
+    bool IsFinished() const noexcept { return m_ReadOffset >= m_Size; }
+
+    std::size_t GetReadOffset() const noexcept { return m_ReadOffset; }
+    void SetReadOffset(std::size_t pos) {
+        if (pos > m_Size)
+            throw std::out_of_range("DataBufferView read offset out of range.");
+        m_ReadOffset = pos;
+    }
+
+    u8 operator[](std::size_t i) const noexcept { return m_Data[i]; }
+};
+
+} // ns mc
+
+#endif
@@ -4,11 +4,26 @@
 #include <mclib/mclib.h>
 #include <mclib/common/Types.h>
 
+#include <cstddef>
 #include <iosfwd>
 
 namespace mc {
 
 class DataBuffer;
+class DataBufferView;
+
+// Result of decoding data that might not have been fully received yet.
+enum class DecodeResult {
+    Success,
+    // More data has to be received before the value can be decoded.
+    Incomplete,
+    // The data can't be decoded no matter how much more is received.
+    Malformed,
+    // The packet id isn't known in the current protocol state.
+    UnknownPacket,
+    // The packet is known, but nothing would handle it so it wasn't decoded.
+    Skipped
+};
 
 class VarInt {
 private:
@@ -26,17 +41,48 @@ public:
     s32 GetInt() const noexcept { return (s32)m_Value; }
     s64 GetLong() const noexcept { return m_Value; }
 
+    // Returns how many bytes value takes up when serialized as a VarInt.
+    static constexpr std::size_t GetSerializedLength(s64 value) noexcept {
+        return 1 + ((u64)value >= (1ULL << 7)) + ((u64)value >= (1ULL << 14)) + ((u64)value >= (1ULL << 21)) +
+            ((u64)value >= (1ULL << 28)) + ((u64)value >= (1ULL << 35)) + ((u64)value >= (1ULL << 42)) +
+            ((u64)value >= (1ULL << 49)) + ((u64)value >= (1ULL << 56)) + ((u64)value >= (1ULL << 63));
+    }
+
     // Returns how many bytes this will take up in a buffer
-    std::size_t MCLIB_API GetSerializedLength() const;
+    std::size_t GetSerializedLength() const noexcept { return GetSerializedLength(m_Value); }
 
     friend MCLIB_API DataBuffer& operator<<(DataBuffer& out, const VarInt& pos);
     friend MCLIB_API DataBuffer& operator>>(DataBuffer& in, VarInt& pos);
+    friend MCLIB_API DataBufferView& operator>>(DataBufferView& in, VarInt& pos);
 };
 
 typedef VarInt VarLong;
 
 MCLIB_API DataBuffer& operator<<(DataBuffer& out, const VarInt& var);
 MCLIB_API DataBuffer& operator>>(DataBuffer& in, VarInt& var);
+MCLIB_API DataBufferView& operator>>(DataBufferView& in, VarInt& var);
+
+// Encodes value into data, which needs room for VarInt::GetSerializedLength(value) bytes. Returns the bytes written.
+MCLIB_API std::size_t WriteVarInt(u8* data, s64 value) noexcept;
+
+/**
+ * Decodes a VarInt from the start of data without throwing.
+ * On success, value is set and length is the number of bytes it took up.
+ * Returns Incomplete if data ends inside the VarInt and Malformed if it's longer than the type allows.
+ */
+MCLIB_API DecodeResult TryReadVarInt(const u8* data, std::size_t size, s32& value, std::size_t& length) noexcept;
+MCLIB_API DecodeResult TryReadVarInt(const u8* data, std::size_t size, s64& value, std::size_t& length) noexcept;
+// Only advances the view when the VarInt was decoded.
+MCLIB_API DecodeResult TryReadVarInt(DataBufferView& in, VarInt& var) noexcept;
+
+/**
+ * Decodes count consecutive VarInts into values, like the entries of a palette.
+ * length is set to the total number of bytes read on success.
+ */
+MCLIB_API DecodeResult TryReadVarInts(const u8* data, std::size_t size, s32* values, std::size_t count, std::size_t& length) noexcept;
+// Throws std::out_of_range if the data ends early, the same as reading each VarInt on its own.
+MCLIB_API DataBuffer& ReadVarInts(DataBuffer& in, s32* values, std::size_t count);
+MCLIB_API DataBufferView& ReadVarInts(DataBufferView& in, s32* values, std::size_t count);
 
 } // ns mc
 
@@ -9,6 +9,7 @@
 #include <mclib/inventory/Inventory.h>
 #include <mclib/inventory/Hotbar.h>
 #include <mclib/network/Network.h>
+#include <mclib/network/Reactor.h>
 #include <mclib/protocol/packets/PacketDispatcher.h>
 #include <mclib/util/ObserverSubject.h>
 #include <mclib/world/World.h>
@@ -32,10 +33,12 @@ public:
 enum class UpdateMethod {
     Block,
     Threaded,
-    Manual
+    Manual,
+    // Driven by the reactor set with SetReactor. Many clients can share one reactor thread.
+    Reactor
 };
 
-class Client : public util::ObserverSubject<ClientListener>, public core::ConnectionListener {
+class Client : public util::ObserverSubject<ClientListener>, public core::ConnectionListener, public network::ReactorListener {
 private:
     protocol::packets::PacketDispatcher* m_Dispatcher;
     core::Connection m_Connection;
@@ -45,10 +48,13 @@ private:
     inventory::Hotbar m_Hotbar;
     std::unique_ptr<util::PlayerController> m_PlayerController;
     world::World m_World;
+    network::Reactor* m_Reactor;
     s64 m_LastUpdate;
     bool m_Connected;
     std::thread m_UpdateThread;
 
+    void UpdateTick();
+
 public:
     MCLIB_API Client(protocol::packets::PacketDispatcher* dispatcher, protocol::Version version = protocol::Version::Minecraft_1_11_2);
     MCLIB_API ~Client();
@@ -59,12 +65,17 @@ public:
     Client& operator=(Client&& rhs) = delete;
 
     void MCLIB_API OnSocketStateChange(network::Socket::Status newState);
+    void MCLIB_API OnPoll() override;
     void MCLIB_API UpdateThread();
     void MCLIB_API Update();
     bool MCLIB_API Login(const std::string& host, unsigned short port, const std::string& user, const std::string& password, UpdateMethod method = UpdateMethod::Block);
     bool MCLIB_API Login(const std::string& host, unsigned short port, const std::string& user, AuthToken token, UpdateMethod method = UpdateMethod::Block);
     void MCLIB_API Ping(const std::string& host, unsigned short port, UpdateMethod method = UpdateMethod::Block);
 
+    // Shares the reactor with the connection. Must outlive the client or be reset to null first.
+    void MCLIB_API SetReactor(network::Reactor* reactor);
+    network::Reactor* GetReactor() { return m_Reactor; }
+
     protocol::packets::PacketDispatcher* GetDispatcher() { return m_Dispatcher; }
     core::Connection* GetConnection() { return &m_Connection; }
     core::PlayerManager* GetPlayerManager() { return &m_PlayerManager; }
@@ -3,38 +3,56 @@
 
 #include <mclib/mclib.h>
 #include <mclib/common/Types.h>
+#include <mclib/common/DataBufferView.h>
 
 namespace mc {
 
-class DataBuffer;
-
 namespace core {
 
 class CompressionStrategy {
 public:
     virtual MCLIB_API ~CompressionStrategy() { }
     virtual DataBuffer MCLIB_API Compress(DataBuffer& buffer) = 0;
-    virtual DataBuffer MCLIB_API Decompress(DataBuffer& buffer, std::size_t packetLength) = 0;
+    /**
+     * Reads one packet from the frame and returns a view of its uncompressed data.
+     * The view points either into the frame or into memory owned by the strategy,
+     * so it's only valid until the next call.
+     */
+    virtual DataBufferView MCLIB_API Decompress(DataBufferView& frame, std::size_t packetLength) = 0;
 };
 
 class CompressionNone : public CompressionStrategy {
 public:
     DataBuffer MCLIB_API Compress(DataBuffer& buffer);
-    DataBuffer MCLIB_API Decompress(DataBuffer& buffer, std::size_t packetLength);
+    DataBufferView MCLIB_API Decompress(DataBufferView& frame, std::size_t packetLength);
 };
 
 class CompressionZ : public CompressionStrategy {
 private:
+    // Keeps the zlib streams and their output buffers alive between packets.
+    class Impl;
+    Impl* m_Impl;
+
     // How large a packet needs to be before it's compressed.
     // Don't compress packets smaller than this.
     // Received in SetCompressionPacket.
     u64 m_CompressionThreshold;
 
 public:
-    MCLIB_API CompressionZ(u64 threshold) : m_CompressionThreshold(threshold) { }
+    // zlib level used for outbound packets. Z_BEST_SPEED, since the packets are small and sent often.
+    static const s32 DefaultLevel = 1;
+
+    // level is a zlib compression level from 0 to 9.
+    MCLIB_API CompressionZ(u64 threshold, s32 level = DefaultLevel);
+    MCLIB_API ~CompressionZ();
+
+    CompressionZ(const CompressionZ& other) = delete;
+    CompressionZ& operator=(const CompressionZ& other) = delete;
+    CompressionZ(CompressionZ&& other) = delete;
+    CompressionZ& operator=(CompressionZ&& other) = delete;
 
     DataBuffer MCLIB_API Compress(DataBuffer& buffer);
-    DataBuffer MCLIB_API Decompress(DataBuffer& buffer, std::size_t packetLength);
+    DataBufferView MCLIB_API Decompress(DataBufferView& frame, std::size_t packetLength);
 };
 
 } // ns core
@@ -8,7 +8,9 @@
 #include <mclib/core/ClientSettings.h>
 #include <mclib/core/Compression.h>
 #include <mclib/core/Encryption.h>
+#include <mclib/network/Reactor.h>
 #include <mclib/network/Socket.h>
+#include <mclib/network/StreamBuffer.h>
 #include <mclib/protocol/Protocol.h>
 #include <mclib/protocol/packets/Packet.h>
 #include <mclib/protocol/packets/PacketHandler.h>
@@ -31,29 +33,42 @@ public:
     virtual void MCLIB_API OnLogin(bool success) { }
     virtual void MCLIB_API OnAuthentication(bool success, std::string error) { }
     virtual void MCLIB_API OnPingResponse(const nlohmann::json& node) { }
+    // Called with true when the unsent data reaches the high watermark and with false once it drains to the low watermark.
+    virtual void MCLIB_API OnBackpressure(bool active) { }
 };
 
-class Connection : public protocol::packets::PacketHandler, public util::ObserverSubject<ConnectionListener> {
+class Connection : public protocol::packets::PacketHandler, public network::ReactorHandler, public util::ObserverSubject<ConnectionListener> {
 private:
     std::unique_ptr<EncryptionStrategy> m_Encrypter;
     std::unique_ptr<CompressionStrategy> m_Compressor;
     std::unique_ptr<network::Socket> m_Socket;
     std::unique_ptr<util::Yggdrasil> m_Yggdrasil;
+    network::Reactor* m_Reactor;
+    network::SocketHandle m_ReactorHandle;
     ClientSettings m_ClientSettings;
     std::string m_Server;
     std::string m_Email;
     std::string m_Username;
     std::string m_Password;
-    DataBuffer m_HandleBuffer;
+    network::StreamBuffer m_ReceiveBuffer;
+    network::StreamBuffer m_SendBuffer;
+    std::size_t m_SendLowWatermark;
+    std::size_t m_SendHighWatermark;
     protocol::Protocol& m_Protocol;
     protocol::State m_ProtocolState;
     u16 m_Port;
     bool m_SentSettings;
+    bool m_AutoFlush;
+    bool m_Backpressure;
     s32 m_Dimension;
+    s32 m_CompressionLevel;
 
     void AuthenticateClient(const std::wstring& serverId, const std::string& sharedSecret, const std::string& pubkey);
-    protocol::packets::Packet* CreatePacket(DataBuffer& buffer);
+    bool ProcessFrame();
     void SendSettingsPacket();
+    void RegisterWithReactor();
+    void UnregisterFromReactor();
+    void UpdateSendState();
 
 public:
     MCLIB_API Connection(protocol::packets::PacketDispatcher* dispatcher, protocol::Version version = protocol::Version::Minecraft_1_11_2);
@@ -73,6 +88,29 @@ public:
 
     void SendSettings() noexcept { m_SentSettings = false; }
 
+    /**
+     * When auto flush is enabled every packet is sent as soon as SendPacket is called.
+     * Otherwise packets are queued and sent together with one send call when Flush is called.
+     * Enabled by default. Client disables it and flushes once per update.
+     */
+    void SetAutoFlush(bool autoFlush) noexcept { m_AutoFlush = autoFlush; }
+    bool IsAutoFlush() const noexcept { return m_AutoFlush; }
+
+    // zlib level used for outbound packets once the server enables compression.
+    void SetCompressionLevel(s32 level) noexcept { m_CompressionLevel = level; }
+    // Amount of data waiting to be sent, including what didn't fit in the socket on the last flush.
+    std::size_t GetQueuedSize() const noexcept { return m_SendBuffer.GetSize(); }
+
+    bool IsBackpressured() const noexcept { return m_Backpressure; }
+    void SetSendWatermarks(std::size_t low, std::size_t high) noexcept { m_SendLowWatermark = low; m_SendHighWatermark = high; }
+
+    network::Reactor* GetReactor() const noexcept { return m_Reactor; }
+    // Hands the socket to a shared reactor. CreatePacket is then called whenever data arrives.
+    void MCLIB_API SetReactor(network::Reactor* reactor);
+
+    void MCLIB_API OnReadable() override;
+    void MCLIB_API OnWritable() override;
+
     void MCLIB_API HandlePacket(protocol::packets::in::KeepAlivePacket* packet);
     void MCLIB_API HandlePacket(protocol::packets::in::PlayerPositionAndLookPacket* packet);
     void MCLIB_API HandlePacket(protocol::packets::in::DisconnectPacket* packet);
@@ -87,6 +125,11 @@ public:
     bool MCLIB_API Connect(const std::string& server, u16 port);
     void MCLIB_API Disconnect();
     void MCLIB_API CreatePacket();
+    /**
+     * Sends as much of the queued data as the socket accepts without blocking.
+     * Whatever is left is retried on the next flush, or when the socket becomes writable if a reactor is set.
+     */
+    void MCLIB_API Flush();
 
     void MCLIB_API Ping();
     bool MCLIB_API Login(const std::string& username, const std::string& password);
@@ -99,9 +142,14 @@ public:
         packet.SetProtocolVersion(m_Protocol.GetVersion());
         DataBuffer packetBuffer = packet.Serialize();
         DataBuffer compressed = m_Compressor->Compress(packetBuffer);
-        DataBuffer encrypted = m_Encrypter->Encrypt(compressed);
+        std::size_t size = compressed.GetSize();
+
+        // Frames are encrypted in place once queued. They have to be queued in order because the encryption stream depends on it.
+        m_SendBuffer.Write(&compressed[0], size);
+        m_Encrypter->Encrypt(m_SendBuffer.GetWritePointer() - size, size);
 
-        m_Socket->Send(encrypted);
+        if (m_AutoFlush)
+            Flush();
     }
 
     template <typename T>
@@ -14,14 +14,23 @@ namespace core {
 
 struct EncryptionStrategy {
     virtual ~EncryptionStrategy() { }
-    virtual DataBuffer Encrypt(const DataBuffer& buffer) = 0;
-    virtual DataBuffer Decrypt(const DataBuffer& buffer) = 0;
+
+    // Encrypts or decrypts size bytes in place. The data has to be passed in stream order.
+    virtual void Encrypt(u8* data, std::size_t size) = 0;
+    virtual void Decrypt(u8* data, std::size_t size) = 0;
+
+    // Returns a transformed copy of the buffer.
+    DataBuffer MCLIB_API Encrypt(const DataBuffer& buffer);
+    DataBuffer MCLIB_API Decrypt(const DataBuffer& buffer);
 };
 
 class EncryptionStrategyNone : public EncryptionStrategy {
 public:
-    DataBuffer MCLIB_API Encrypt(const DataBuffer& buffer);
-    DataBuffer MCLIB_API Decrypt(const DataBuffer& buffer);
+    using EncryptionStrategy::Encrypt;
+    using EncryptionStrategy::Decrypt;
+
+    void Encrypt(u8* data, std::size_t size) { }
+    void Decrypt(u8* data, std::size_t size) { }
 };
 
 class EncryptionStrategyAES : public EncryptionStrategy {
@@ -38,8 +47,11 @@ public:
     EncryptionStrategyAES(EncryptionStrategyAES&& other) = delete;
     EncryptionStrategyAES& operator=(EncryptionStrategyAES&& other) = delete;
 
-    DataBuffer MCLIB_API Encrypt(const DataBuffer& buffer);
-    DataBuffer MCLIB_API Decrypt(const DataBuffer& buffer);
+    using EncryptionStrategy::Encrypt;
+    using EncryptionStrategy::Decrypt;
+
+    void MCLIB_API Encrypt(u8* data, std::size_t size);
+    void MCLIB_API Decrypt(u8* data, std::size_t size);
 
     std::string MCLIB_API GetSharedSecret() const;
     MCLIB_API protocol::packets::out::EncryptionResponsePacket* GenerateResponsePacket() const;
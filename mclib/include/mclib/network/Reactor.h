@@ -0,0 +1,82 @@
+#ifndef NETWORK_REACTOR_H_
+#define NETWORK_REACTOR_H_
+
+#include <mclib/common/Types.h>
+#include <mclib/network/Socket.h>
+#include <mclib/util/ObserverSubject.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace mc {
+namespace network {
+
+// Receives readiness events for a socket registered with a Reactor.
+class ReactorHandler {
+public:
+    virtual MCLIB_API ~ReactorHandler() { }
+
+    virtual void MCLIB_API OnReadable() { }
+    virtual void MCLIB_API OnWritable() { }
+};
+
+class ReactorListener {
+public:
+    virtual MCLIB_API ~ReactorListener() { }
+
+    // Called once per Poll after the ready sockets were handled. Used for periodic work like ticking.
+    virtual void MCLIB_API OnPoll() { }
+};
+
+/**
+ * Waits on many sockets from one thread and only wakes the handlers whose sockets are ready.
+ * Uses epoll on Linux and poll everywhere else.
+ * Not thread safe. Register, unregister and poll from the thread that runs the reactor.
+ */
+class Reactor : public util::ObserverSubject<ReactorListener> {
+public:
+    enum Event { Readable = 1, Writable = 2 };
+
+private:
+    struct Registration {
+        ReactorHandler* handler;
+        u32 events;
+    };
+
+    std::unordered_map<SocketHandle, Registration> m_Registrations;
+#ifdef __linux__
+    int m_EpollHandle;
+#endif
+    bool m_Running;
+
+public:
+    MCLIB_API Reactor();
+    MCLIB_API ~Reactor();
+
+    Reactor(const Reactor& other) = delete;
+    Reactor& operator=(const Reactor& rhs) = delete;
+    Reactor(Reactor&& other) = delete;
+    Reactor& operator=(Reactor&& rhs) = delete;
+
+    // events is a mask of Event values
+    bool MCLIB_API Register(SocketHandle handle, ReactorHandler* handler, u32 events = Readable);
+    bool MCLIB_API Modify(SocketHandle handle, u32 events);
+    void MCLIB_API Unregister(SocketHandle handle);
+
+    std::size_t GetSize() const noexcept { return m_Registrations.size(); }
+
+    /**
+     * Waits up to timeout milliseconds for socket events and dispatches them.
+     * Returns the number of sockets that were handled.
+     */
+    std::size_t MCLIB_API Poll(s32 timeout);
+
+    // Polls until Stop is called.
+    void MCLIB_API Run(s32 timeout = 10);
+    void MCLIB_API Stop();
+};
+
+} // ns network
+} // ns mc
+
+#endif
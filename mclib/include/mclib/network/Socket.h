@@ -71,10 +71,13 @@ public:
     std::size_t MCLIB_API Send(const std::string& data);
     std::size_t MCLIB_API Send(DataBuffer& buffer);
 
+    // Returns the amount sent. This can be less than size if the socket is nonblocking and its send buffer is full.
     virtual std::size_t Send(const uint8_t* data, std::size_t size) = 0;
     virtual DataBuffer Receive(std::size_t amount) = 0;
 
     virtual std::size_t Receive(DataBuffer& buffer, std::size_t amount) = 0;
+    // Receives up to amount bytes directly into buffer. Returns 0 if nothing was available.
+    virtual std::size_t Receive(u8* buffer, std::size_t amount) = 0;
 };
 
 typedef std::shared_ptr<Socket> SocketPtr;
@@ -0,0 +1,66 @@
+#ifndef NETWORK_STREAM_BUFFER_H_
+#define NETWORK_STREAM_BUFFER_H_
+
+#include <mclib/common/Types.h>
+
+#include <vector>
+
+namespace mc {
+namespace network {
+
+/**
+ * Growable byte queue used for socket streams.
+ * Data is appended at the write cursor and consumed from the read cursor, so the readable
+ * region is always contiguous and can be parsed in place.
+ * Consumed space is only reclaimed when the buffer needs room at the end, which moves
+ * the unread bytes (at most one partial packet) instead of the whole buffer.
+ */
+class StreamBuffer {
+private:
+    std::vector<u8> m_Buffer;
+    std::size_t m_ReadOffset;
+    std::size_t m_WriteOffset;
+
+    void Compact();
+
+public:
+    MCLIB_API StreamBuffer(std::size_t initialCapacity = 0);
+
+    StreamBuffer(const StreamBuffer& other) = delete;
+    StreamBuffer& operator=(const StreamBuffer& other) = delete;
+    StreamBuffer(StreamBuffer&& other) = default;
+    StreamBuffer& operator=(StreamBuffer&& other) = default;
+
+    u8* GetReadPointer() noexcept { return m_Buffer.data() + m_ReadOffset; }
+    const u8* GetReadPointer() const noexcept { return m_Buffer.data() + m_ReadOffset; }
+    u8* GetWritePointer() noexcept { return m_Buffer.data() + m_WriteOffset; }
+
+    // Amount of unread data
+    std::size_t GetSize() const noexcept { return m_WriteOffset - m_ReadOffset; }
+    // Amount of space available after the write cursor without moving or growing
+    std::size_t GetWritable() const noexcept { return m_Buffer.size() - m_WriteOffset; }
+    std::size_t GetCapacity() const noexcept { return m_Buffer.size(); }
+    bool IsEmpty() const noexcept { return m_ReadOffset == m_WriteOffset; }
+
+    /**
+     * Makes sure there's room for at least amount bytes after the write cursor.
+     * Returns the write pointer. Call CommitWrite with the amount actually written.
+     */
+    MCLIB_API u8* PrepareWrite(std::size_t amount);
+    void MCLIB_API CommitWrite(std::size_t amount);
+    void MCLIB_API Write(const u8* data, std::size_t size);
+
+    /**
+     * Makes sure the readable region can grow to size bytes without moving again.
+     * Used once a frame length is known so the rest of the frame is received in place.
+     */
+    void MCLIB_API Reserve(std::size_t size);
+
+    void MCLIB_API Consume(std::size_t amount);
+    void MCLIB_API Clear();
+};
+
+} // ns network
+} // ns mc
+
+#endif
@@ -22,6 +22,7 @@ public:
     std::size_t MCLIB_API Send(const u8* data, std::size_t size);
     DataBuffer MCLIB_API Receive(std::size_t amount);
     std::size_t MCLIB_API Receive(DataBuffer& buffer, std::size_t amount);
+    std::size_t MCLIB_API Receive(u8* buffer, std::size_t amount);
 };
 
 } // ns network
@@ -3,8 +3,10 @@
 
 #include <mclib/protocol/ProtocolState.h>
 #include <mclib/protocol/packets/Packet.h>
-#include <unordered_map>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace mc {
 namespace protocol {
@@ -27,22 +29,95 @@ public:
     }
 };
 
+// Maps an outbound packet class to its index in the outbound id tables.
+template <typename T>
+struct OutboundTag;
+
+#define MCLIB_OUTBOUND_TAG(type, tag) \
+    template <> struct OutboundTag<packets::out::type> { \
+        static const outbound::ProtocolOutbound Id = outbound::tag; \
+        static const char* GetName() { return #type; } \
+    };
+
+MCLIB_OUTBOUND_TAG(HandshakePacket, Handshake)
+MCLIB_OUTBOUND_TAG(LoginStartPacket, LoginStart)
+MCLIB_OUTBOUND_TAG(EncryptionResponsePacket, EncryptionResponse)
+MCLIB_OUTBOUND_TAG(LoginPluginResponsePacket, LoginPluginResponse)
+MCLIB_OUTBOUND_TAG(status::RequestPacket, StatusRequest)
+MCLIB_OUTBOUND_TAG(status::PingPacket, StatusPing)
+MCLIB_OUTBOUND_TAG(TeleportConfirmPacket, TeleportConfirm)
+MCLIB_OUTBOUND_TAG(TabCompletePacket, TabComplete)
+MCLIB_OUTBOUND_TAG(ChatPacket, Chat)
+MCLIB_OUTBOUND_TAG(ClientStatusPacket, ClientStatus)
+MCLIB_OUTBOUND_TAG(ClientSettingsPacket, ClientSettings)
+MCLIB_OUTBOUND_TAG(ConfirmTransactionPacket, ConfirmTransaction)
+MCLIB_OUTBOUND_TAG(EnchantItemPacket, EnchantItem)
+MCLIB_OUTBOUND_TAG(ClickWindowPacket, ClickWindow)
+MCLIB_OUTBOUND_TAG(CloseWindowPacket, CloseWindow)
+MCLIB_OUTBOUND_TAG(PluginMessagePacket, PluginMessage)
+MCLIB_OUTBOUND_TAG(UseEntityPacket, UseEntity)
+MCLIB_OUTBOUND_TAG(KeepAlivePacket, KeepAlive)
+MCLIB_OUTBOUND_TAG(PlayerPositionPacket, PlayerPosition)
+MCLIB_OUTBOUND_TAG(PlayerPositionAndLookPacket, PlayerPositionAndLook)
+MCLIB_OUTBOUND_TAG(PlayerLookPacket, PlayerLook)
+MCLIB_OUTBOUND_TAG(PlayerPacket, Player)
+MCLIB_OUTBOUND_TAG(VehicleMovePacket, VehicleMove)
+MCLIB_OUTBOUND_TAG(SteerBoatPacket, SteerBoat)
+MCLIB_OUTBOUND_TAG(PlayerAbilitiesPacket, PlayerAbilities)
+MCLIB_OUTBOUND_TAG(PlayerDiggingPacket, PlayerDigging)
+MCLIB_OUTBOUND_TAG(EntityActionPacket, EntityAction)
+MCLIB_OUTBOUND_TAG(SteerVehiclePacket, SteerVehicle)
+MCLIB_OUTBOUND_TAG(ResourcePackStatusPacket, ResourcePackStatus)
+MCLIB_OUTBOUND_TAG(HeldItemChangePacket, HeldItemChange)
+MCLIB_OUTBOUND_TAG(CreativeInventoryActionPacket, CreativeInventoryAction)
+MCLIB_OUTBOUND_TAG(UpdateSignPacket, UpdateSign)
+MCLIB_OUTBOUND_TAG(AnimationPacket, Animation)
+MCLIB_OUTBOUND_TAG(SpectatePacket, Spectate)
+MCLIB_OUTBOUND_TAG(PlayerBlockPlacementPacket, PlayerBlockPlacement)
+MCLIB_OUTBOUND_TAG(UseItemPacket, UseItem)
+MCLIB_OUTBOUND_TAG(PrepareCraftingGridPacket, PrepareCraftingGrid)
+MCLIB_OUTBOUND_TAG(CraftingBookDataPacket, CraftingBookData)
+MCLIB_OUTBOUND_TAG(AdvancementTabPacket, AdvancementTab)
+MCLIB_OUTBOUND_TAG(CraftRecipeRequestPacket, CraftRecipeRequest)
+#undef MCLIB_OUTBOUND_TAG
+
+// Outbound packet ids of one protocol version, indexed by outbound::ProtocolOutbound. Unsupported packets are -1.
+struct OutboundTable {
+    s32 ids[outbound::Count];
+};
+
 class Protocol {
 public:
     typedef std::unordered_map<State, PacketMap> StateMap;
 
 protected:
-    StateMap m_InboundMap;
+    struct InboundType {
+        PacketCreator creator;
+        s32 agnosticId;
+    };
+
+    static const std::size_t StateCount = 4;
+
+    // Indexed by protocol id for each state. Unknown ids have an agnostic id of -1.
+    // Known packets that mclib can't create yet have a null creator.
+    std::vector<InboundType> m_InboundTypes[StateCount];
+    const OutboundTable* m_OutboundTable;
     Version m_Version;
 
-public:
-    Protocol(Version version, StateMap inbound)
-        : m_InboundMap(inbound),
-          m_Version(version)
-    {
+    const InboundType* GetInboundType(State state, s32 protocolId) const noexcept {
+        auto& types = m_InboundTypes[(std::size_t)state];
+
+        if (protocolId < 0 || (std::size_t)protocolId >= types.size() || types[protocolId].agnosticId < 0)
+            return nullptr;
 
+        return &types[protocolId];
     }
 
+    [[noreturn]] void MCLIB_API ThrowUnsupported(const char* name) const;
+
+public:
+    MCLIB_API Protocol(Version version, const StateMap& inbound, const OutboundTable& outbound);
+
     virtual ~Protocol() { }
 
     virtual Version GetVersion() const noexcept { return m_Version; }
@@ -52,57 +127,33 @@ public:
 
     // Convert the protocol id into a protocol agnostic id.
     // This is used as the dispatching id.
-    bool GetAgnosticId(State state, s32 protocolId, s32& agnosticId);
-
-    // Handshake
-    virtual s32 GetPacketId(packets::out::HandshakePacket) { return 0x00; }
-
-    // Login
-    virtual s32 GetPacketId(packets::out::LoginStartPacket) { return 0x00; }
-    virtual s32 GetPacketId(packets::out::EncryptionResponsePacket) { return 0x01; }
-    virtual s32 GetPacketId(packets::out::LoginPluginResponsePacket) { throw UnsupportedPacketException("LoginPluginResponse requires protocol 1.15.2"); }
-
-    // Status
-    virtual s32 GetPacketId(packets::out::status::RequestPacket) { return 0x00; }
-    virtual s32 GetPacketId(packets::out::status::PingPacket) { return 0x01; }
-
-    // Play
-    virtual s32 GetPacketId(packets::out::TeleportConfirmPacket) { return 0x00; }
-    virtual s32 GetPacketId(packets::out::TabCompletePacket) { return 0x01; }
-    virtual s32 GetPacketId(packets::out::ChatPacket) { return 0x02; }
-    virtual s32 GetPacketId(packets::out::ClientStatusPacket) { return 0x03; }
-    virtual s32 GetPacketId(packets::out::ClientSettingsPacket) { return 0x04; }
-    virtual s32 GetPacketId(packets::out::ConfirmTransactionPacket) { return 0x05; }
-    virtual s32 GetPacketId(packets::out::EnchantItemPacket) { return 0x06; }
-    virtual s32 GetPacketId(packets::out::ClickWindowPacket) { return 0x07; }
-    virtual s32 GetPacketId(packets::out::CloseWindowPacket) { return 0x08; }
-    virtual s32 GetPacketId(packets::out::PluginMessagePacket) { return 0x09; }
-    virtual s32 GetPacketId(packets::out::UseEntityPacket) { return 0x0A; }
-    virtual s32 GetPacketId(packets::out::KeepAlivePacket) { return 0x0B; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionPacket) { return 0x0C; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionAndLookPacket) { return 0x0D; }
-    virtual s32 GetPacketId(packets::out::PlayerLookPacket) { return 0x0E; }
-    virtual s32 GetPacketId(packets::out::PlayerPacket) { return 0x0F; }
-    virtual s32 GetPacketId(packets::out::VehicleMovePacket) { return 0x10; }
-    virtual s32 GetPacketId(packets::out::SteerBoatPacket) { return 0x11; }
-    virtual s32 GetPacketId(packets::out::PlayerAbilitiesPacket) { return 0x12; }
-    virtual s32 GetPacketId(packets::out::PlayerDiggingPacket) { return 0x13; }
-    virtual s32 GetPacketId(packets::out::EntityActionPacket) { return 0x14; }
-    virtual s32 GetPacketId(packets::out::SteerVehiclePacket) { return 0x15; }
-    virtual s32 GetPacketId(packets::out::ResourcePackStatusPacket) { return 0x16; }
-    virtual s32 GetPacketId(packets::out::HeldItemChangePacket) { return 0x17; }
-    virtual s32 GetPacketId(packets::out::CreativeInventoryActionPacket) { return 0x18; }
-    virtual s32 GetPacketId(packets::out::UpdateSignPacket) { return 0x19; }
-    virtual s32 GetPacketId(packets::out::AnimationPacket) { return 0x1A; }
-    virtual s32 GetPacketId(packets::out::SpectatePacket) { return 0x1B; }
-    virtual s32 GetPacketId(packets::out::PlayerBlockPlacementPacket) { return 0x1C; }
-    virtual s32 GetPacketId(packets::out::UseItemPacket) { return 0x1D; }
-
-    virtual s32 GetPacketId(packets::out::PrepareCraftingGridPacket) { throw UnsupportedPacketException("PrepareCraftingGridPacket requires protocol 1.12.0"); }
-    virtual s32 GetPacketId(packets::out::CraftingBookDataPacket) { throw UnsupportedPacketException("CraftingBookDataPacket requires protocol 1.12.0"); }
-    virtual s32 GetPacketId(packets::out::AdvancementTabPacket) { throw UnsupportedPacketException("AdvancementTabPacket requires protocol 1.12.0"); }
-
-    virtual s32 GetPacketId(packets::out::CraftRecipeRequestPacket) { throw UnsupportedPacketException("CraftRecipeRequestPacket requires protocol 1.12.1"); }
+    bool GetAgnosticId(State state, s32 protocolId, s32& agnosticId) const noexcept {
+        const InboundType* type = GetInboundType(state, protocolId);
+
+        if (type == nullptr) return false;
+
+        agnosticId = type->agnosticId;
+        return true;
+    }
+
+    // Returns the id of the outbound packet type T in this protocol.
+    // Throws UnsupportedPacketException if this protocol doesn't have the packet.
+    template <typename T>
+    s32 GetPacketId() const {
+        using Tag = OutboundTag<typename std::decay<T>::type>;
+
+        s32 id = m_OutboundTable->ids[Tag::Id];
+
+        if (id < 0)
+            ThrowUnsupported(Tag::GetName());
+
+        return id;
+    }
+
+    template <typename T>
+    s32 GetPacketId(const T&) const {
+        return GetPacketId<T>();
+    }
 
     static Protocol& GetProtocol(Version version);
 };
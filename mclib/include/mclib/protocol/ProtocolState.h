@@ -153,10 +153,61 @@ enum ProtocolPlay {
     Advancements,
     UnlockRecipes,
     CraftRecipeResponse,
+    UpdateLight,
 };
 
 } // ns play
 
+// Every serverbound packet, independent of the protocol version. Indexes the per-version outbound id tables.
+namespace outbound {
+
+enum ProtocolOutbound {
+    Handshake,
+    LoginStart,
+    EncryptionResponse,
+    LoginPluginResponse,
+    StatusRequest,
+    StatusPing,
+    TeleportConfirm,
+    TabComplete,
+    Chat,
+    ClientStatus,
+    ClientSettings,
+    ConfirmTransaction,
+    EnchantItem,
+    ClickWindow,
+    CloseWindow,
+    PluginMessage,
+    UseEntity,
+    KeepAlive,
+    PlayerPosition,
+    PlayerPositionAndLook,
+    PlayerLook,
+    Player,
+    VehicleMove,
+    SteerBoat,
+    PlayerAbilities,
+    PlayerDigging,
+    EntityAction,
+    SteerVehicle,
+    ResourcePackStatus,
+    HeldItemChange,
+    CreativeInventoryAction,
+    UpdateSign,
+    Animation,
+    Spectate,
+    PlayerBlockPlacement,
+    UseItem,
+    PrepareCraftingGrid,
+    CraftingBookData,
+    AdvancementTab,
+    CraftRecipeRequest,
+
+    Count
+};
+
+} // ns outbound
+
 } // ns protocol
 } // ns mc
 
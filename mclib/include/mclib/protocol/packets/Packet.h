@@ -3,6 +3,7 @@
 
 #include <mclib/block/BlockEntity.h>
 #include <mclib/common/DataBuffer.h>
+#include <mclib/common/DataBufferView.h>
 #include <mclib/common/Json.h>
 #include <mclib/common/MCString.h>
 #include <mclib/common/Position.h>
@@ -37,6 +38,8 @@ class PacketHandler;
 class Packet {
 protected:
     VarInt m_Id;
+    // Protocol agnostic id of the packet type. Set when an inbound packet is created by the protocol.
+    s32 m_AgnosticId;
     protocol::State m_ProtocolState;
     protocol::Version m_ProtocolVersion;
     // The connection that is processing this packet.
@@ -45,6 +48,7 @@ protected:
 public:
     Packet() noexcept 
         : m_Id(0xFF), 
+          m_AgnosticId(-1),
           m_ProtocolState(protocol::State::Play), 
           m_Connection(nullptr), 
           m_ProtocolVersion(protocol::Version::Minecraft_1_11_2) 
@@ -61,21 +65,41 @@ public:
     protocol::State GetProtocolState() const noexcept { return m_ProtocolState; }
     protocol::Version GetProtocolVersion() const noexcept { return m_ProtocolVersion; }
     VarInt GetId() const noexcept{ return m_Id; }
+    s32 GetAgnosticId() const noexcept { return m_AgnosticId; }
 
     virtual DataBuffer Serialize() const = 0;
     virtual bool Deserialize(DataBuffer& data, std::size_t packetLength) = 0;
     virtual void Dispatch(PacketHandler* handler) = 0;
 
     void SetId(s32 id) { m_Id = id; }
+    void SetAgnosticId(s32 id) noexcept { m_AgnosticId = id; }
     void SetProtocolVersion(protocol::Version version) noexcept { m_ProtocolVersion = version; }
     MCLIB_API void SetConnection(core::Connection* connection);
     MCLIB_API core::Connection* GetConnection();
 };
 
 class InboundPacket : public Packet {
+protected:
+    // For packets that override the view version. Parses the DataBuffer through a view of it.
+    bool MCLIB_API DeserializeFromView(DataBuffer& data, std::size_t packetLength);
+
 public:
     virtual ~InboundPacket() { }
     DataBuffer Serialize() const { return DataBuffer(); }
+
+    /**
+     * Clears the packet so PacketFactory can reuse it for the next packet of the same type.
+     * Returns false if the packet can't be reused, in which case it's deleted instead.
+     * Packets that append to containers while deserializing need to clear them here.
+     */
+    virtual bool Reset() { return false; }
+
+    using Packet::Deserialize;
+    /**
+     * Deserializes straight from the received data.
+     * The default copies the data into a DataBuffer. Frequent packets override this to skip the copy.
+     */
+    virtual bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
 };
 
 class OutboundPacket : public Packet {
@@ -442,6 +466,7 @@ public:
     MCLIB_API BlockChangePacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     Vector3i GetPosition() const { return m_Position; }
     s32 GetBlockId() const { return m_BlockId; }
@@ -546,6 +571,7 @@ public:
     MCLIB_API MultiBlockChangePacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { m_BlockChanges.clear(); return true; }
 
     s32 GetChunkX() const { return m_ChunkX; }
     s32 GetChunkZ() const { return m_ChunkZ; }
@@ -719,6 +745,7 @@ public:
     MCLIB_API EntityStatusPacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
     u8 GetStatus() const { return m_Status; }
@@ -754,6 +781,7 @@ public:
     MCLIB_API UnloadChunkPacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     s32 GetChunkX() const { return m_ChunkX; }
     s32 GetChunkZ() const { return m_ChunkZ; }
@@ -786,7 +814,9 @@ private:
 public:
     MCLIB_API KeepAlivePacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     s64 GetAliveId() const { return m_AliveId; }
 };
@@ -920,7 +950,9 @@ private:
 public:
     MCLIB_API EntityRelativeMovePacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
     // Change in position as (current * 32 - prev * 32) * 128
@@ -975,7 +1007,9 @@ private:
 public:
     MCLIB_API EntityLookAndRelativeMovePacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
     Vector3s GetDelta() const { return m_Delta; }
@@ -994,7 +1028,9 @@ private:
 public:
     MCLIB_API EntityLookPacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
     u8 GetYaw() const { return m_Yaw; }
@@ -1010,6 +1046,7 @@ public:
     MCLIB_API EntityPacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
 };
@@ -1264,7 +1301,9 @@ private:
 public:
     MCLIB_API EntityHeadLookPacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
     u8 GetYaw() const { return m_Yaw; }
@@ -1409,7 +1448,9 @@ private:
 public:
     MCLIB_API EntityVelocityPacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
 
@@ -1575,7 +1616,9 @@ private:
 public:
     MCLIB_API TimeUpdatePacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     s64 GetWorldAge() const { return m_WorldAge; }
     s64 GetTime() const { return m_Time; }
@@ -1665,7 +1708,9 @@ private:
 public:
     MCLIB_API EntityTeleportPacket();
     bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    bool MCLIB_API Deserialize(DataBufferView& data, std::size_t packetLength);
     void MCLIB_API Dispatch(PacketHandler* handler);
+    bool Reset() { return true; }
 
     EntityId GetEntityId() const { return m_EntityId; }
     Vector3d GetPosition() const { return m_Position; }
@@ -1733,6 +1778,37 @@ public:
     void MCLIB_API Dispatch(PacketHandler* handler);
 };
 
+// Light of a chunk column, sent on its own since 1.14.
+class UpdateLightPacket : public InboundPacket {
+public:
+    // Section index from -1 to 16 and its light levels.
+    typedef std::vector<std::pair<s32, world::NibbleArray>> SectionLight;
+
+private:
+    s32 m_ChunkX;
+    s32 m_ChunkZ;
+    bool m_TrustEdges;
+    // Sections that aren't in a list keep their current light.
+    SectionLight m_SkyLight;
+    SectionLight m_BlockLight;
+
+public:
+    MCLIB_API UpdateLightPacket();
+    bool MCLIB_API Deserialize(DataBuffer& data, std::size_t packetLength);
+    void MCLIB_API Dispatch(PacketHandler* handler);
+
+    s32 GetChunkX() const noexcept { return m_ChunkX; }
+    s32 GetChunkZ() const noexcept { return m_ChunkZ; }
+    // Only sent since 1.16.
+    bool GetTrustEdges() const noexcept { return m_TrustEdges; }
+    // Sections from the empty masks are included as uniform zero light.
+    const SectionLight& GetSkyLight() const noexcept { return m_SkyLight; }
+    const SectionLight& GetBlockLight() const noexcept { return m_BlockLight; }
+
+    // Applies the sections in this packet to light.
+    void MCLIB_API Apply(world::ColumnLight& light) const;
+};
+
 
 
 namespace status {
@@ -4,7 +4,6 @@
 #include <mclib/protocol/Protocol.h>
 #include <mclib/protocol/packets/Packet.h>
 
-#include <map>
 #include <vector>
 
 namespace mc {
@@ -16,8 +15,22 @@ class PacketHandler;
 class PacketDispatcher {
 private:
     typedef s64 PacketId;
-    typedef std::pair<State, PacketId> PacketType;
-    std::map<PacketType, std::vector<PacketHandler*>> m_Handlers;
+
+    struct PacketType {
+        std::vector<PacketHandler*> handlers;
+        bool alwaysDecode = false;
+    };
+
+    static const std::size_t StateCount = 4;
+
+    // Packet types indexed by protocol state and then by protocol agnostic id.
+    // Agnostic ids are small and dense, so dispatching is a direct index.
+    std::vector<PacketType> m_Types[StateCount];
+
+    PacketType* GetType(State protocolState, PacketId id);
+    const PacketType* GetType(State protocolState, PacketId id) const;
+    PacketType& GetOrCreateType(State protocolState, PacketId id);
+    void Compact(State protocolState);
 
 public:
     PacketDispatcher() = default;
@@ -32,6 +45,20 @@ public:
     void MCLIB_API RegisterHandler(State protocolState, PacketId id, PacketHandler* handler);
     void MCLIB_API UnregisterHandler(State protocolState, PacketId id, PacketHandler* handler);
     void MCLIB_API UnregisterHandler(PacketHandler* handler);
+
+    bool MCLIB_API HasHandlers(State protocolState, PacketId id) const;
+
+    /**
+     * Packets without handlers are skipped instead of deserialized.
+     * Marking a packet type as always decoded makes the factory deserialize it anyway.
+     */
+    void MCLIB_API SetAlwaysDecode(State protocolState, PacketId id, bool decode = true);
+
+    // Whether a received packet of this type needs to be deserialized.
+    bool MCLIB_API ShouldDecode(State protocolState, PacketId id) const;
+
+    // How many packet ids the table of a state covers, up to the highest id with handlers or always decoded.
+    std::size_t MCLIB_API GetTableSize(State protocolState) const;
 };
 
 } // ns packets
@@ -2,6 +2,7 @@
 #define PACKETS_PACKET_FACTORY_H_
 
 #include <mclib/common/DataBuffer.h>
+#include <mclib/common/DataBufferView.h>
 #include <mclib/protocol/Protocol.h>
 #include <mclib/protocol/packets/Packet.h>
 
@@ -16,8 +17,17 @@ namespace packets {
 
 class PacketFactory {
 public:
-    static MCLIB_API Packet* CreatePacket(Protocol& protocol, State state, DataBuffer data, std::size_t length, core::Connection* connection = nullptr);
+    /**
+     * Decodes a packet without throwing for packets that are unknown or unhandled.
+     * packet is only set when Success is returned. It has to be released with FreePacket.
+     * data is only read during the call, so it can point into the receive buffer.
+     */
+    static MCLIB_API DecodeResult TryCreatePacket(Protocol& protocol, State state, DataBufferView data, std::size_t length, core::Connection* connection, Packet*& packet);
+    // Same as TryCreatePacket, but throws UnfinishedProtocolException for unknown packets.
+    static MCLIB_API Packet* CreatePacket(Protocol& protocol, State state, DataBufferView data, std::size_t length, core::Connection* connection = nullptr);
     static void MCLIB_API FreePacket(Packet* packet);
+    // Number of freed packets of a type that the calling thread keeps for reuse.
+    static std::size_t MCLIB_API GetFreeCount(State state, s32 agnosticId);
 };
 
 } // ns packets
@@ -119,6 +119,7 @@ public:
     virtual void HandlePacket(in::EntityEffectPacket* packet) { } // 0x4B
     virtual void HandlePacket(in::AdvancementProgressPacket* packet) { }
     virtual void HandlePacket(in::CraftRecipeResponsePacket* packet) { }
+    virtual void HandlePacket(in::UpdateLightPacket* packet) { }
 };
 
 } // ns packets
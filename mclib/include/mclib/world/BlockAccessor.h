@@ -0,0 +1,106 @@
+#ifndef MCLIB_WORLD_BLOCK_ACCESSOR_H_
+#define MCLIB_WORLD_BLOCK_ACCESSOR_H_
+
+#include <mclib/mclib.h>
+#include <mclib/common/Types.h>
+#include <mclib/common/Vector.h>
+#include <mclib/world/World.h>
+
+namespace mc {
+namespace world {
+
+/**
+ * Reads blocks from a World through a cursor that remembers the last column and section it used.
+ * Queries that stay inside the same 16x16x16 section skip the chunk lookup, the shared_ptr copies
+ * and the bounds checks of World::GetBlock, so walking neighboring blocks is much cheaper.
+ *
+ * The cached section isn't tracked, so only use an accessor for the length of one query.
+ * Create a new one, or call Invalidate, after the world handled packets.
+ */
+class BlockAccessor {
+private:
+    const World* m_World;
+    // Looked up once instead of on every query.
+    const block::BlockRegistry* m_Registry;
+    Vector3i m_Position;
+
+    // Section coordinates (block coordinates >> 4) of m_Section.
+    s64 m_SectionX;
+    s64 m_SectionY;
+    s64 m_SectionZ;
+    ChunkColumn* m_Column;
+    // Null for missing sections, which are all air.
+    const Chunk* m_Section;
+
+    // Looks up the section at section coordinates x, y, z, reusing the column if it didn't change.
+    void MCLIB_API Resolve(s64 x, s64 y, s64 z);
+
+public:
+    MCLIB_API explicit BlockAccessor(const World& world);
+    MCLIB_API BlockAccessor(const World& world, Vector3i position);
+
+    // Drops the cached column and section.
+    void MCLIB_API Invalidate();
+
+    const Vector3i& GetPosition() const noexcept { return m_Position; }
+    void MoveTo(Vector3i position) noexcept { m_Position = position; }
+
+    void Offset(s64 dx, s64 dy, s64 dz) noexcept {
+        m_Position.x += dx;
+        m_Position.y += dy;
+        m_Position.z += dz;
+    }
+
+    // Returns the block state id at world position x, y, z. Unloaded blocks are air.
+    u32 GetStateId(s64 x, s64 y, s64 z) {
+        if ((x >> 4) != m_SectionX || (y >> 4) != m_SectionY || (z >> 4) != m_SectionZ)
+            Resolve(x >> 4, y >> 4, z >> 4);
+
+        if (!m_Section) return 0;
+        if (m_Section->IsSingleValue()) return m_Section->GetSingleValue();
+
+        return m_Section->GetStateId((std::size_t)(((y & 15) << 8) | ((z & 15) << 4) | (x & 15)));
+    }
+
+    u32 GetStateId(Vector3i position) { return GetStateId(position.x, position.y, position.z); }
+    // Returns the block state id at the cursor.
+    u32 GetStateId() { return GetStateId(m_Position.x, m_Position.y, m_Position.z); }
+
+    block::BlockPtr Get(s64 x, s64 y, s64 z) {
+        return m_Registry->GetBlock(GetStateId(x, y, z));
+    }
+
+    block::BlockPtr Get(Vector3i position) { return Get(position.x, position.y, position.z); }
+    block::BlockPtr Get() { return Get(m_Position.x, m_Position.y, m_Position.z); }
+
+    bool IsSolid(s64 x, s64 y, s64 z) {
+        return m_Registry->IsSolid(GetStateId(x, y, z));
+    }
+
+    bool IsSolid(Vector3i position) { return IsSolid(position.x, position.y, position.z); }
+    bool IsSolid() { return IsSolid(m_Position.x, m_Position.y, m_Position.z); }
+
+    /**
+     * Calls func(Vector3i position, u32 stateId) for the six blocks that share a face with the cursor.
+     * Neighbors in the same section are read without another lookup.
+     */
+    template <typename Func>
+    void ForEachNeighbor(Func&& func) {
+        static const s8 offsets[6][3] = {
+            { -1, 0, 0 }, { 1, 0, 0 },
+            { 0, -1, 0 }, { 0, 1, 0 },
+            { 0, 0, -1 }, { 0, 0, 1 }
+        };
+
+        for (const auto& offset : offsets) {
+            Vector3i neighbor(m_Position.x + offset[0], m_Position.y + offset[1], m_Position.z + offset[2]);
+
+            func(neighbor, GetStateId(neighbor.x, neighbor.y, neighbor.z));
+        }
+    }
+};
+
+} // ns world
+} // ns mc
+
+#endif
@@ -5,10 +5,15 @@
 #include "mclib/block/BlockEntity.h"
 #include "mclib/common/Types.h"
 #include "mclib/nbt/NBT.h"
+#include "mclib/world/Heightmap.h"
+#include "mclib/world/Light.h"
 
 #include <array>
 #include <map>
 #include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace mc {
 
@@ -27,12 +32,52 @@ struct ChunkColumnMetadata {
 
 /**
  * A 16x16x16 area. A ChunkColumn is made up of 16 of these
+ * A new Chunk is a single value section of air.
  */
 class Chunk {
+public:
+    // How the entries are packed into the longs of the data array.
+    enum class Layout {
+        // Entries can start in one long and end in the next one. Used up to 1.15.2.
+        Spanning,
+        // Entries never cross longs and the leftover high bits of each long are unused. Used since 1.16.
+        Aligned
+    };
+
 private:
+    struct PackedAccess;
+
     std::vector<u32> m_Palette;
+    // State id to palette index. Built on the first SetBlock after loading.
+    std::unordered_map<u32, u32> m_PaletteIndex;
+    // Number of blocks using each palette entry. Built on the first SetBlock after loading, empty for global ids.
+    std::vector<u16> m_PaletteCounts;
+    // Empty while the whole section is m_SingleValue.
     std::vector<u64> m_Data;
+    u32 m_SingleValue;
+    // 0 while the section is a single value.
     u8 m_BitsPerBlock;
+    Layout m_Layout;
+    // Reads and writes entries for the current bits per block and layout.
+    const PackedAccess* m_Access;
+
+    // Sets the storage format and selects the matching accessor.
+    void SetFormat(u8 bitsPerBlock, Layout layout);
+    // Switches to a single value section, freeing the packed data.
+    void SetSingleValue(u32 value);
+    // Expands a single value section into packed data so other blocks can be set.
+    void Promote();
+    // Repacks the data with more bits per block. Above 8 bits the palette is dropped for global ids.
+    void Resize(u8 bitsPerBlock);
+    // Returns the palette index of a state id, adding it to the palette and growing the data if needed.
+    // Returns the state id itself once the section stores global ids.
+    u32 GetOrAddPaletteIndex(u32 blockType);
+    // Counts how many blocks use each palette entry.
+    void CountPaletteEntries();
+    // Whether every entry of the packed data is the same.
+    bool HasSingleEntry() const;
+    u32 GetEntry(std::size_t index) const;
+    void SetEntry(std::size_t index, u32 value);
 
 public:
     MCLIB_API Chunk();
@@ -44,6 +89,24 @@ public:
      */
     block::BlockPtr MCLIB_API GetBlock(Vector3i chunkPosition) const;
 
+    /**
+     * Returns the block state id at index y * 256 + z * 16 + x without a registry lookup.
+     * The index isn't bounds checked.
+     */
+    u32 MCLIB_API GetStateId(std::size_t index) const;
+
+    /**
+     * Writes the state ids of count blocks starting at index begin into out.
+     * Decodes the packed data in order, so this is much cheaper than calling GetStateId for each block.
+     */
+    void MCLIB_API GetStateIds(std::size_t begin, std::size_t count, u32* out) const;
+
+    /**
+     * Appends the index of every block from begin to begin + count whose state is in stateIds.
+     * Palette sections check their palette first and return right away if nothing in it matches.
+     */
+    void MCLIB_API FindStateIds(const std::set<u32>& stateIds, std::size_t begin, std::size_t count, std::vector<u16>& indices) const;
+
     /**
     * Position is relative to this chunk position
     */
@@ -53,6 +116,21 @@ public:
      * chunkIndex is the index (0-16) of this chunk in the ChunkColumn
      */
     void MCLIB_API Load(DataBuffer& in, ChunkColumnMetadata* meta, s32 chunkIndex, protocol::Version version);
+
+    // Whole sections of one block, like stone underground or air above the terrain, don't store packed data.
+    // Sections go back to a single value once SetBlock makes them uniform, except for sections of global ids.
+    bool IsSingleValue() const noexcept { return m_Data.empty(); }
+    u32 GetSingleValue() const noexcept { return m_SingleValue; }
+
+    // State ids of the palette entries. Empty for single value sections and sections of global ids.
+    // Entries stay in the palette after their last block is replaced.
+    const std::vector<u32>& GetPalette() const noexcept { return m_Palette; }
+
+    u8 GetBitsPerBlock() const noexcept { return m_BitsPerBlock; }
+    Layout GetLayout() const noexcept { return m_Layout; }
+
+    // Returns how many longs are needed to store a section with this format.
+    static MCLIB_API std::size_t GetDataSize(u8 bitsPerBlock, Layout layout);
 };
 
 typedef std::shared_ptr<Chunk> ChunkPtr;
@@ -74,8 +152,18 @@ private:
     std::array<ChunkPtr, ChunksPerColumn> m_Chunks;
     ChunkColumnMetadata m_Metadata;
     std::map<Vector3i, block::BlockEntityPtr> m_BlockEntities;
+    // One bit per state id that may occur in the column. Ids are only added, so it can report states that were replaced.
+    std::vector<u64> m_StateSummary;
+    // False when a section stores global ids, then every state may occur.
+    bool m_StateSummaryComplete;
+    ColumnLight m_Light;
+    // Indexed by Heightmap::Type.
+    std::array<Heightmap, 2> m_Heightmaps;
     protocol::Version m_ProtocolVersion;
 
+    // Returns the height above the highest block at or below top that counts for the heightmap type.
+    s32 FindHeight(const block::BlockRegistry* registry, Heightmap::Type type, s32 x, s32 top, s32 z) const;
+
 public:
     MCLIB_API ChunkColumn(ChunkColumnMetadata metadata, protocol::Version protocolVersion);
 
@@ -126,6 +214,29 @@ public:
     block::BlockPtr MCLIB_API GetBlock(Vector3i position);
     const ChunkColumnMetadata& GetMetadata() const { return m_Metadata; }
 
+    ColumnLight& GetLight() noexcept { return m_Light; }
+    const ColumnLight& GetLight() const noexcept { return m_Light; }
+
+    Heightmap& GetHeightmap(Heightmap::Type type) noexcept { return m_Heightmaps[(std::size_t)type]; }
+    const Heightmap& GetHeightmap(Heightmap::Type type) const noexcept { return m_Heightmaps[(std::size_t)type]; }
+
+    // Computes the heightmaps from the sections, for versions that don't send them.
+    void MCLIB_API UpdateHeightmaps();
+    // Updates the heightmaps after the block at x, y, z changed to stateId. x and z are relative to the column.
+    void MCLIB_API UpdateHeight(s32 x, s32 y, s32 z, u32 stateId);
+
+    // Rebuilds the state summary from the section palettes. Called after loading and after sections are replaced.
+    void MCLIB_API UpdateStateSummary();
+    // Records a state that was set in the column.
+    void MCLIB_API AddToStateSummary(u32 stateId);
+
+    // Returns false only if no block in the column has the state.
+    bool MayContain(u32 stateId) const noexcept {
+        if (!m_StateSummaryComplete) return true;
+
+        return (stateId >> 6) < m_StateSummary.size() && ((m_StateSummary[stateId >> 6] >> (stateId & 63)) & 1) != 0;
+    }
+
     MCLIB_API block::BlockEntityPtr GetBlockEntity(Vector3i worldPos);
     std::vector<block::BlockEntityPtr> MCLIB_API GetBlockEntities();
 
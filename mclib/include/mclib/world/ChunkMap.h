@@ -0,0 +1,139 @@
+#ifndef MCLIB_WORLD_CHUNK_MAP_H_
+#define MCLIB_WORLD_CHUNK_MAP_H_
+
+#include <mclib/mclib.h>
+#include <mclib/common/Types.h>
+#include <mclib/world/Chunk.h>
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace mc {
+namespace world {
+
+/**
+ * Open addressing hash table from chunk coordinates to chunk columns.
+ * Uses linear probing and keeps the load factor at or below one half, so a lookup is a multiply,
+ * a shift and usually a single slot compare.
+ * Erasing shifts the following entries back instead of leaving tombstones.
+ */
+class ChunkMap {
+public:
+    typedef std::pair<s32, s32> ChunkCoord;
+    typedef std::pair<ChunkCoord, ChunkColumnPtr> value_type;
+
+private:
+    struct Slot {
+        value_type entry;
+        bool used;
+
+        Slot() : used(false) { }
+    };
+
+    std::vector<Slot> m_Slots;
+    std::size_t m_Size;
+    // Number of low bits of the slot index, the capacity is always 1 << m_Bits.
+    u32 m_Bits;
+
+    std::size_t GetHome(s32 x, s32 z) const noexcept {
+        u64 key = ((u64)(u32)x << 32) | (u32)z;
+        // Fibonacci hashing, the high bits of the product are well mixed.
+        return (std::size_t)((key * 0x9E3779B97F4A7C15ULL) >> (64 - m_Bits));
+    }
+
+    std::size_t GetMask() const noexcept { return m_Slots.size() - 1; }
+
+    void MCLIB_API Rehash(u32 bits);
+
+public:
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef const ChunkMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type* pointer;
+        typedef value_type& reference;
+
+    private:
+        const Slot* m_Slot;
+        const Slot* m_End;
+
+        void SkipUnused() noexcept {
+            while (m_Slot != m_End && !m_Slot->used)
+                ++m_Slot;
+        }
+
+    public:
+        const_iterator(const Slot* slot, const Slot* end) noexcept : m_Slot(slot), m_End(end) { SkipUnused(); }
+
+        const value_type& operator*() const noexcept { return m_Slot->entry; }
+        const value_type* operator->() const noexcept { return &m_Slot->entry; }
+
+        const_iterator& operator++() noexcept {
+            ++m_Slot;
+            SkipUnused();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept { return m_Slot == other.m_Slot; }
+        bool operator!=(const const_iterator& other) const noexcept { return m_Slot != other.m_Slot; }
+    };
+
+    MCLIB_API ChunkMap();
+
+    /**
+     * Finds the column stored at chunk coordinates x, z.
+     * Returns nullptr when nothing was stored there, or when an empty column was stored.
+     */
+    ChunkColumn* Find(s32 x, s32 z) const noexcept {
+        const ChunkColumnPtr* column = FindEntry(x, z);
+
+        return column ? column->get() : nullptr;
+    }
+
+    // Returns the stored entry, which can itself be null, or nullptr if x, z is not in the map.
+    const ChunkColumnPtr* FindEntry(s32 x, s32 z) const noexcept {
+        if (m_Size == 0) return nullptr;
+
+        std::size_t mask = GetMask();
+
+        for (std::size_t i = GetHome(x, z); ; i = (i + 1) & mask) {
+            const Slot& slot = m_Slots[i];
+
+            if (!slot.used) return nullptr;
+            if (slot.entry.first.first == x && slot.entry.first.second == z)
+                return &slot.entry.second;
+        }
+    }
+
+    bool Contains(s32 x, s32 z) const noexcept { return FindEntry(x, z) != nullptr; }
+
+    // Stores column at x, z, replacing any column that was already there.
+    void MCLIB_API Insert(s32 x, s32 z, ChunkColumnPtr column);
+    // Returns false if nothing was stored at x, z.
+    bool MCLIB_API Erase(s32 x, s32 z);
+    void MCLIB_API Clear();
+
+    // Grows the table so it can hold count columns without rehashing.
+    void MCLIB_API Reserve(std::size_t count);
+
+    std::size_t GetSize() const noexcept { return m_Size; }
+    std::size_t GetCapacity() const noexcept { return m_Slots.size(); }
+    bool IsEmpty() const noexcept { return m_Size == 0; }
+
+    const_iterator begin() const noexcept { return const_iterator(m_Slots.data(), m_Slots.data() + m_Slots.size()); }
+    const_iterator end() const noexcept { return const_iterator(m_Slots.data() + m_Slots.size(), m_Slots.data() + m_Slots.size()); }
+};
+
+} // ns world
+} // ns mc
+
+#endif
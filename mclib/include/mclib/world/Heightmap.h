@@ -0,0 +1,60 @@
+#ifndef MCLIB_WORLD_HEIGHTMAP_H_
+#define MCLIB_WORLD_HEIGHTMAP_H_
+
+#include <mclib/mclib.h>
+#include <mclib/common/Types.h>
+
+#include <array>
+#include <vector>
+
+namespace mc {
+namespace world {
+
+/**
+ * Height of the highest matching block for each of the 16x16 columns of a chunk column.
+ * Heights are one above that block, so 0 means there is no matching block.
+ * Stored as 9 bit entries packed seven to a long, the same as the 1.16 protocol.
+ */
+class Heightmap {
+public:
+    enum class Type {
+        // Solid blocks and fluids, from BlockRegistry::IsMotionBlocking.
+        MotionBlocking,
+        // Any block that isn't air.
+        WorldSurface
+    };
+
+    enum { Bits = 9, PerLong = 64 / Bits, LongCount = (16 * 16 + PerLong - 1) / PerLong };
+
+private:
+    std::array<u64, LongCount> m_Data;
+
+public:
+    MCLIB_API Heightmap();
+
+    s32 Get(s32 x, s32 z) const noexcept {
+        const std::size_t index = (std::size_t)((z << 4) | x);
+
+        return (s32)((m_Data[index / PerLong] >> ((index % PerLong) * Bits)) & ((1 << Bits) - 1));
+    }
+
+    void Set(s32 x, s32 z, s32 height) noexcept {
+        const std::size_t index = (std::size_t)((z << 4) | x);
+        const std::size_t shift = (index % PerLong) * Bits;
+        const u64 mask = (u64)((1 << Bits) - 1) << shift;
+        u64& packed = m_Data[index / PerLong];
+
+        packed = (packed & ~mask) | (((u64)height << shift) & mask);
+    }
+
+    /**
+     * Loads the long array of a heightmap from the chunk data. Up to 1.15 entries span across longs.
+     * Returns false and leaves the heightmap unchanged if data has the wrong size.
+     */
+    bool MCLIB_API Load(const std::vector<s64>& data, bool aligned);
+};
+
+} // ns world
+} // ns mc
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MCLIB_WORLD_LIGHT_H_
+#define MCLIB_WORLD_LIGHT_H_
+
+#include <mclib/mclib.h>
+#include <mclib/common/Types.h>
+
+#include <array>
+#include <memory>
+
+namespace mc {
+namespace world {
+
+/**
+ * Light levels of one 16x16x16 section, kept in the 4 bits per block format the protocol sends.
+ * Levels are read straight out of the packed bytes. Arrays where every block has the same level
+ * share one immutable array per level instead of owning their own 2048 bytes.
+ */
+class NibbleArray {
+public:
+    enum { Size = 16 * 16 * 16 / 2 };
+    typedef std::array<u8, Size> Bytes;
+
+private:
+    std::shared_ptr<const Bytes> m_Data;
+
+    static MCLIB_API const std::shared_ptr<const Bytes>& GetUniform(u8 level);
+
+public:
+    // Every block has the same level.
+    MCLIB_API explicit NibbleArray(u8 level = 0);
+    // Copies Size bytes of packed levels, or shares the uniform storage if they are all the same level.
+    MCLIB_API explicit NibbleArray(const u8* data);
+
+    // Index is y * 256 + z * 16 + x. Even indices are in the low nibble.
+    u8 Get(std::size_t index) const noexcept {
+        return ((*m_Data)[index >> 1] >> ((index & 1) << 2)) & 15;
+    }
+
+    u8 Get(s32 x, s32 y, s32 z) const noexcept {
+        return Get((std::size_t)((y << 8) | (z << 4) | x));
+    }
+
+    bool MCLIB_API IsUniform() const noexcept;
+
+    const Bytes& GetBytes() const noexcept { return *m_Data; }
+};
+
+/**
+ * Sky and block light of a chunk column.
+ * Covers the sections from one below the world to one above it, the same as the 1.14+ light masks.
+ */
+class ColumnLight {
+public:
+    enum { SectionCount = 18 };
+
+private:
+    std::array<NibbleArray, SectionCount> m_SkyLight;
+    std::array<NibbleArray, SectionCount> m_BlockLight;
+
+public:
+    // Sky light starts out fully lit in dimensions that have a sky, block light starts out dark.
+    MCLIB_API explicit ColumnLight(bool skylight = true);
+
+    // Section goes from -1 to 16. Sections outside of that are ignored.
+    void MCLIB_API SetSkyLight(s32 section, const NibbleArray& light);
+    void MCLIB_API SetBlockLight(s32 section, const NibbleArray& light);
+
+    // x and z are relative to the column, y is the world height. Heights outside of the stored sections are 0.
+    u8 GetSkyLight(s32 x, s32 y, s32 z) const noexcept {
+        const s32 section = (y >> 4) + 1;
+
+        if (section < 0 || section >= SectionCount) return 0;
+
+        return m_SkyLight[section].Get(x, y & 15, z);
+    }
+
+    u8 GetBlockLight(s32 x, s32 y, s32 z) const noexcept {
+        const s32 section = (y >> 4) + 1;
+
+        if (section < 0 || section >= SectionCount) return 0;
+
+        return m_BlockLight[section].Get(x, y & 15, z);
+    }
+
+    const NibbleArray& GetSkyLight(s32 section) const noexcept { return m_SkyLight[section + 1]; }
+    const NibbleArray& GetBlockLight(s32 section) const noexcept { return m_BlockLight[section + 1]; }
+};
+
+} // ns world
+} // ns mc
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef MCLIB_WORLD_SECTION_RANGE_H_
+#define MCLIB_WORLD_SECTION_RANGE_H_
+
+#include <mclib/common/Vector.h>
+#include <mclib/world/Chunk.h>
+#include <mclib/world/ChunkMap.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace mc {
+namespace world {
+
+/**
+ * The loaded sections that intersect the blocks from min to max, with max excluded.
+ * Missing and all air sections are skipped. Sections are visited column by column, bottom to top.
+ * The range is only valid until a column in it is loaded or unloaded.
+ */
+class SectionRange {
+public:
+    struct Entry {
+        const Chunk& section;
+        // World position of the first block in the section.
+        Vector3i origin;
+    };
+
+    class const_iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Entry value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef Entry reference;
+
+    private:
+        // Null once the iterator reached the end.
+        const SectionRange* m_Range;
+        const ChunkColumn* m_Column;
+        const Chunk* m_Section;
+        s64 m_X;
+        s64 m_Y;
+        s64 m_Z;
+
+        // Moves to the next section to visit, going to the next column once this one runs out.
+        void Next() noexcept {
+            for (;;) {
+                if (m_Column) {
+                    while (++m_Y <= m_Range->m_MaxY) {
+                        const Chunk* section = (*m_Column)[(std::size_t)m_Y].get();
+
+                        if (section && !(section->IsSingleValue() && section->GetSingleValue() == 0)) {
+                            m_Section = section;
+                            return;
+                        }
+                    }
+                }
+
+                if (++m_X > m_Range->m_MaxX) {
+                    m_X = m_Range->m_MinX;
+
+                    if (++m_Z > m_Range->m_MaxZ) {
+                        m_Range = nullptr;
+                        return;
+                    }
+                }
+
+                m_Column = m_Range->m_Chunks->Find((s32)m_X, (s32)m_Z);
+                m_Y = m_Range->m_MinY - 1;
+            }
+        }
+
+    public:
+        explicit const_iterator(const SectionRange* range) noexcept
+            : m_Range(range), m_Column(nullptr), m_Section(nullptr), m_X(0), m_Y(0), m_Z(0)
+        {
+            if (!m_Range) return;
+
+            m_X = m_Range->m_MinX - 1;
+            m_Z = m_Range->m_MinZ;
+            Next();
+        }
+
+        Entry operator*() const noexcept {
+            return Entry{ *m_Section, Vector3i(m_X * 16, m_Y * 16, m_Z * 16) };
+        }
+
+        const_iterator& operator++() noexcept {
+            Next();
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept {
+            if (!m_Range || !other.m_Range) return m_Range == other.m_Range;
+
+            return m_X == other.m_X && m_Y == other.m_Y && m_Z == other.m_Z;
+        }
+
+        bool operator!=(const const_iterator& other) const noexcept { return !(*this == other); }
+    };
+
+private:
+    const ChunkMap* m_Chunks;
+    // Section coordinates, all inclusive.
+    s64 m_MinX;
+    s64 m_MinY;
+    s64 m_MinZ;
+    s64 m_MaxX;
+    s64 m_MaxY;
+    s64 m_MaxZ;
+
+public:
+    SectionRange(const ChunkMap& chunks, Vector3i min, Vector3i max) noexcept
+        : m_Chunks(&chunks),
+          m_MinX(min.x >> 4), m_MinY(std::max<s64>(min.y >> 4, 0)), m_MinZ(min.z >> 4),
+          m_MaxX((max.x - 1) >> 4), m_MaxY(std::min<s64>((max.y - 1) >> 4, ChunkColumn::ChunksPerColumn - 1)), m_MaxZ((max.z - 1) >> 4)
+    {
+        if (min.x >= max.x || min.y >= max.y || min.z >= max.z || m_MinY > m_MaxY)
+            m_Chunks = nullptr;
+    }
+
+    const_iterator begin() const noexcept { return const_iterator(m_Chunks ? this : nullptr); }
+    const_iterator end() const noexcept { return const_iterator(nullptr); }
+};
+
+} // ns world
+} // ns mc
+
+#endif
@@ -1,12 +1,18 @@
 #ifndef MCLIB_WORLD_WORLD_H_
 #define MCLIB_WORLD_WORLD_H_
 
+#include <mclib/common/AABB.h>
 #include <mclib/world/Chunk.h>
+#include <mclib/world/ChunkMap.h>
+#include <mclib/world/SectionRange.h>
 #include <mclib/protocol/packets/PacketHandler.h>
 #include <mclib/protocol/packets/PacketDispatcher.h>
 #include <mclib/util/ObserverSubject.h>
 
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <set>
 
 namespace mc {
 namespace world {
@@ -21,9 +27,15 @@ public:
 
 class World : public protocol::packets::PacketHandler, public util::ObserverSubject<WorldListener> {
 private:
-    typedef std::pair<s32, s32> ChunkCoord;
+    ChunkMap m_Chunks;
 
-    std::map<ChunkCoord, ChunkColumnPtr> m_Chunks;
+    // Light for columns that aren't loaded yet. Servers send the light of a column before its chunk data.
+    struct PendingLight {
+        protocol::packets::in::UpdateLightPacket::SectionLight sky;
+        protocol::packets::in::UpdateLightPacket::SectionLight block;
+    };
+
+    std::map<ChunkMap::ChunkCoord, PendingLight> m_PendingLight;
 
     bool MCLIB_API SetBlock(Vector3i position, u32 blockData);
 
@@ -43,22 +55,121 @@ public:
     void MCLIB_API HandlePacket(protocol::packets::in::ExplosionPacket* packet);
     void MCLIB_API HandlePacket(protocol::packets::in::UpdateBlockEntityPacket* packet);
     void MCLIB_API HandlePacket(protocol::packets::in::RespawnPacket* packet);
+    void MCLIB_API HandlePacket(protocol::packets::in::UpdateLightPacket* packet);
+
+    /**
+     * Sizes the chunk index for a client with the given view distance, so loading the chunks
+     * around the player doesn't rehash it. The index still grows if the server sends more.
+     */
+    void MCLIB_API SetViewDistance(s32 distance);
 
     /**
      * Pos can be any world position inside of the chunk
      */
     ChunkColumnPtr MCLIB_API GetChunk(Vector3i pos) const;
 
+    // Same as GetChunk without touching the reference count. The column is only valid until it is unloaded.
+    ChunkColumn* GetChunkColumn(Vector3i pos) const noexcept {
+        return m_Chunks.Find((s32)(pos.x >> 4), (s32)(pos.z >> 4));
+    }
+
+    // Light levels from 0 to 15. Unloaded positions are dark.
+    u8 MCLIB_API GetSkyLight(Vector3i pos) const;
+    u8 MCLIB_API GetBlockLight(Vector3i pos) const;
+
+    // Height above the highest block of the heightmap type at x, z. Unloaded columns have a height of 0.
+    s32 MCLIB_API GetHeight(s64 x, s64 z, Heightmap::Type type = Heightmap::Type::MotionBlocking) const;
+
     block::BlockPtr MCLIB_API GetBlock(Vector3d pos) const;
     block::BlockPtr MCLIB_API GetBlock(Vector3f pos) const;
     block::BlockPtr MCLIB_API GetBlock(Vector3i pos) const;
 
+    /**
+     * The loaded sections that intersect the blocks from min to max, with max excluded, for iterating with a loop.
+     * Missing and all air sections are skipped without looking at their blocks.
+     */
+    SectionRange GetSections(Vector3i min, Vector3i max) const noexcept {
+        return SectionRange(m_Chunks, min, max);
+    }
+
+    /**
+     * Calls func(const Chunk& section, Vector3i origin) for each section of GetSections(min, max).
+     * origin is the world position of the first block in the section.
+     */
+    template <typename Func>
+    void ForEachSection(Vector3i min, Vector3i max, Func&& func) const {
+        for (const SectionRange::Entry& entry : GetSections(min, max))
+            func(entry.section, entry.origin);
+    }
+
+    /**
+     * Calls func(Vector3i position, u32 stateId) for every block that isn't air from min to max, with max excluded.
+     * Works one section at a time. Uniform sections aren't decoded and the others are decoded once, only for
+     * the layers inside the box.
+     */
+    template <typename Func>
+    void ForEachBlock(Vector3i min, Vector3i max, Func&& func) const {
+        u32 states[16 * 16 * 16];
+
+        ForEachSection(min, max, [&](const Chunk& section, Vector3i origin) {
+            // Part of the box inside this section, relative to the section.
+            const s64 minX = std::max(min.x, origin.x) - origin.x;
+            const s64 minY = std::max(min.y, origin.y) - origin.y;
+            const s64 minZ = std::max(min.z, origin.z) - origin.z;
+            const s64 maxX = std::min(max.x, origin.x + 16) - origin.x;
+            const s64 maxY = std::min(max.y, origin.y + 16) - origin.y;
+            const s64 maxZ = std::min(max.z, origin.z + 16) - origin.z;
+
+            if (section.IsSingleValue()) {
+                const u32 state = section.GetSingleValue();
+
+                for (s64 y = minY; y < maxY; ++y)
+                    for (s64 z = minZ; z < maxZ; ++z)
+                        for (s64 x = minX; x < maxX; ++x)
+                            func(Vector3i(origin.x + x, origin.y + y, origin.z + z), state);
+                return;
+            }
+
+            section.GetStateIds((std::size_t)(minY * 256), (std::size_t)((maxY - minY) * 256), states);
+
+            for (s64 y = minY; y < maxY; ++y) {
+                for (s64 z = minZ; z < maxZ; ++z) {
+                    const u32* row = &states[(y - minY) * 256 + z * 16];
+
+                    for (s64 x = minX; x < maxX; ++x) {
+                        if (row[x] != 0)
+                            func(Vector3i(origin.x + x, origin.y + y, origin.z + z), row[x]);
+                    }
+                }
+            }
+        });
+    }
+
+    // Visits every block that isn't air and overlaps bounds.
+    template <typename Func>
+    void ForEachBlock(const AABB& bounds, Func&& func) const {
+        Vector3i min((s64)std::floor(bounds.min.x), (s64)std::floor(bounds.min.y), (s64)std::floor(bounds.min.z));
+        Vector3i max((s64)std::ceil(bounds.max.x), (s64)std::ceil(bounds.max.y), (s64)std::ceil(bounds.max.z));
+
+        ForEachBlock(min, max, std::forward<Func>(func));
+    }
+
+    /**
+     * Returns the position of every block from min to max, with max excluded, whose state is in stateIds.
+     * Columns whose state summary doesn't have any of the states and sections whose palette doesn't have them
+     * are skipped, so searching for rare blocks only decodes the sections that contain them.
+     */
+    MCLIB_API std::vector<Vector3i> FindBlocks(const std::set<u32>& stateIds, Vector3i min, Vector3i max) const;
+    // Finds the blocks that overlap bounds.
+    MCLIB_API std::vector<Vector3i> FindBlocks(const std::set<u32>& stateIds, const AABB& bounds) const;
+
     MCLIB_API block::BlockEntityPtr GetBlockEntity(Vector3i pos) const;
     // Gets all of the known block entities in loaded chunks
     MCLIB_API std::vector<block::BlockEntityPtr> GetBlockEntities() const;
 
-    const std::map<ChunkCoord, ChunkColumnPtr>::const_iterator begin() const { return m_Chunks.begin(); }
-    const std::map<ChunkCoord, ChunkColumnPtr>::const_iterator end() const { return m_Chunks.end(); }
+    // Iterates the loaded columns in no particular order.
+    ChunkMap::const_iterator begin() const { return m_Chunks.begin(); }
+    ChunkMap::const_iterator end() const { return m_Chunks.end(); }
 };
 
 } // ns world
@@ -2,6 +2,20 @@
 
 namespace{
 
+// Blocks that always hold a fluid. Waterlogged states can't be told apart by name, so they aren't included.
+bool IsFluid(const std::string& name){
+    const char* fluids[] = {
+        "minecraft:water", "minecraft:flowing_water", "minecraft:lava", "minecraft:flowing_lava",
+        "minecraft:bubble_column", "minecraft:kelp", "minecraft:kelp_plant", "minecraft:seagrass", "minecraft:tall_seagrass"
+    };
+
+    for (const char* fluid : fluids){
+        if (name == fluid) return true;
+    }
+
+    return false;
+}
+
 void Register1_12(){
     mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
 
@@ -468,10 +482,87 @@ BlockRegistry* BlockRegistry::GetInstance(){
     return &registry;
 }
 
+BlockRegistry::BlockRegistry()
+    : m_Shapes(1)
+{
+}
+
 BlockRegistry::~BlockRegistry(){
     ClearRegistry();
 }
 
+u16 BlockRegistry::GetShapeIndex(const AABB& bounds){
+    for (std::size_t i = 0; i < m_Shapes.size(); ++i){
+        if (m_Shapes[i].min == bounds.min && m_Shapes[i].max == bounds.max)
+            return (u16)i;
+    }
+
+    m_Shapes.push_back(bounds);
+    return (u16)(m_Shapes.size() - 1);
+}
+
+void BlockRegistry::SetStateProperties(u32 data, BlockPtr block){
+    const u64 bit = 1ULL << (data & 63);
+    const std::size_t word = data >> 6;
+
+    if (word >= m_SolidStates.size()){
+        m_SolidStates.resize(word + 1, 0);
+        m_OpaqueStates.resize(word + 1, 0);
+        m_MotionBlockingStates.resize(word + 1, 0);
+    }
+
+    if (data >= m_ShapeIndices.size())
+        m_ShapeIndices.resize(data + 1, 0);
+
+    m_SolidStates[word] &= ~bit;
+    m_OpaqueStates[word] &= ~bit;
+    m_MotionBlockingStates[word] &= ~bit;
+    m_ShapeIndices[data] = 0;
+
+    if (block == nullptr) return;
+
+    if (block->IsSolid())
+        m_SolidStates[word] |= bit;
+    if (block->IsOpaque())
+        m_OpaqueStates[word] |= bit;
+    if (block->IsSolid() || IsFluid(block->GetName()))
+        m_MotionBlockingStates[word] |= bit;
+
+    m_ShapeIndices[data] = GetShapeIndex(block->GetBoundingBox());
+}
+
+void BlockRegistry::RegisterBlock(BlockPtr block){
+    u32 data = block->GetType();
+
+    m_Blocks[data] = block;
+    m_BlockNames[block->GetName()] = block;
+
+    if (data >= m_States.size())
+        m_States.resize(data + 1, nullptr);
+
+    m_States[data] = block;
+
+    // Unregistered metas of the same block fall back to its base id in GetBlock, so their properties can change too.
+    for (u32 id = data & ~15; id <= (data | 15); ++id){
+        SetStateProperties(id, GetBlock(id));
+    }
+}
+
+void BlockRegistry::UpdateTables(){
+    // Cover the metas past the last registered id that GetBlock falls back to its base id for.
+    const std::size_t count = (m_States.size() + 15) & ~(std::size_t)15;
+
+    m_Shapes.assign(1, AABB());
+    m_SolidStates.assign((count + 63) / 64, 0);
+    m_OpaqueStates.assign(m_SolidStates.size(), 0);
+    m_MotionBlockingStates.assign(m_SolidStates.size(), 0);
+    m_ShapeIndices.assign(count, 0);
+
+    for (u32 data = 0; data < count; ++data){
+        SetStateProperties(data, GetBlock(data));
+    }
+}
+
 void BlockRegistry::RegisterVanillaBlocks(protocol::Version protocolVersion){
     const AABB FullSolidBounds(Vector3d(0, 0, 0), Vector3d(1, 1, 1));
 
@@ -4724,6 +4815,8 @@ void BlockRegistry::RegisterVanillaBlocks(protocol::Version protocolVersion){
         if (kv.second->IsSolid() && (bounds.max - bounds.min).Length() == 0)
             kv.second->SetBoundingBox(FullSolidBounds);
     }
+
+    UpdateTables();
 }
 
 void BlockRegistry::ClearRegistry(){
@@ -4731,6 +4824,14 @@ void BlockRegistry::ClearRegistry(){
         delete pair.second;
     }
     m_Blocks.clear();
+    m_BlockNames.clear();
+
+    m_States.clear();
+    m_SolidStates.clear();
+    m_OpaqueStates.clear();
+    m_MotionBlockingStates.clear();
+    m_ShapeIndices.clear();
+    m_Shapes.assign(1, AABB());
 }
 
 BlockPtr BlockRegistry::GetBlock(const std::string& name) const{
@@ -0,0 +1,162 @@
+#include <mclib/common/ByteSwap.h>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MCLIB_BYTE_SWAP_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+// MSVC allows any intrinsic without enabling the instruction set for the whole file.
+#define MCLIB_TARGET(isa)
+#else
+#define MCLIB_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace {
+
+typedef void (*SwapFunction)(u8* data, std::size_t count, std::size_t elementSize);
+
+inline u16 Swap(u16 value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
+}
+
+inline u32 Swap(u32 value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+inline u64 Swap(u64 value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+template <typename T>
+void SwapScalar(u8* data, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        T value;
+        memcpy(&value, data + i * sizeof(T), sizeof(T));
+        value = Swap(value);
+        memcpy(data + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+void SwapPortable(u8* data, std::size_t count, std::size_t elementSize) {
+    switch (elementSize) {
+        case 2: SwapScalar<u16>(data, count); break;
+        case 4: SwapScalar<u32>(data, count); break;
+        case 8: SwapScalar<u64>(data, count); break;
+        default: break;
+    }
+}
+
+#ifdef MCLIB_BYTE_SWAP_X86
+
+// pshufb control that reverses each element of elementSize bytes within 16 bytes.
+void GetShuffleMask(std::size_t elementSize, u8* mask) {
+    for (std::size_t i = 0; i < 16; ++i) {
+        std::size_t element = i / elementSize;
+        mask[i] = (u8)(element * elementSize + (elementSize - 1 - i % elementSize));
+    }
+}
+
+MCLIB_TARGET("ssse3")
+void SwapSSSE3(u8* data, std::size_t count, std::size_t elementSize) {
+    u8 maskBytes[16];
+    GetShuffleMask(elementSize, maskBytes);
+
+    const __m128i mask = _mm_loadu_si128((const __m128i*)maskBytes);
+    std::size_t size = count * elementSize;
+    std::size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i*)(data + i));
+        _mm_storeu_si128((__m128i*)(data + i), _mm_shuffle_epi8(value, mask));
+    }
+
+    SwapPortable(data + i, (size - i) / elementSize, elementSize);
+}
+
+MCLIB_TARGET("avx2")
+void SwapAVX2(u8* data, std::size_t count, std::size_t elementSize) {
+    u8 maskBytes[32];
+    // vpshufb shuffles within each 128 bit lane, so both lanes use the same control.
+    GetShuffleMask(elementSize, maskBytes);
+    GetShuffleMask(elementSize, maskBytes + 16);
+
+    const __m256i mask = _mm256_loadu_si256((const __m256i*)maskBytes);
+    std::size_t size = count * elementSize;
+    std::size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i value = _mm256_loadu_si256((const __m256i*)(data + i));
+        _mm256_storeu_si256((__m256i*)(data + i), _mm256_shuffle_epi8(value, mask));
+    }
+
+    SwapPortable(data + i, (size - i) / elementSize, elementSize);
+}
+
+SwapFunction SelectSwapFunction() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool ssse3 = (info[2] & (1 << 9)) != 0;
+    // The OS has to save the AVX registers on context switches.
+    bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+
+    bool avx2 = false;
+    if (osAvx && maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool ssse3 = __builtin_cpu_supports("ssse3") != 0;
+    bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+
+    if (avx2) return SwapAVX2;
+    if (ssse3) return SwapSSSE3;
+    return SwapPortable;
+}
+
+#else
+
+SwapFunction SelectSwapFunction() {
+    return SwapPortable;
+}
+
+#endif
+
+} // ns
+
+namespace mc {
+
+void ByteSwapArray(void* data, std::size_t count, std::size_t elementSize) noexcept {
+    static const SwapFunction swap = SelectSwapFunction();
+
+    if (elementSize <= 1 || count == 0) return;
+
+    swap((u8*)data, count, elementSize);
+}
+
+} // ns mc
@@ -1,8 +1,16 @@
 #include <mclib/common/VarInt.h>
 
 #include <mclib/common/DataBuffer.h>
+#include <mclib/common/DataBufferView.h>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <cstring>
 #include <ostream>
+#include <stdexcept>
+#include <type_traits>
 
 namespace mc {
 
@@ -27,52 +35,251 @@ VarInt::VarInt(s64 val) noexcept : m_Value(val)
 
 }
 
-std::size_t VarInt::GetSerializedLength() const {
-    DataBuffer buffer;
-    buffer << *this;
-    return buffer.GetSize();
-}
-
 DataBuffer& operator<<(DataBuffer& out, const VarInt& var) {
-    u64 uval = var.m_Value;
+    std::size_t offset = out.GetSize();
 
-    int encoded = 0;
-    char data[10];
-
-    do {
-        u8 nextByte = uval & 0x7F;
-        uval >>= 7;
-        if (uval)
-            nextByte |= 0x80;
-        data[encoded++] = nextByte;
-    } while (uval);
-    out << std::string(data, encoded);
+    out.Resize(offset + VarInt::GetSerializedLength(var.m_Value));
+    WriteVarInt(&out[offset], var.m_Value);
 
     return out;
 }
 
 DataBuffer& operator>>(DataBuffer& in, VarInt& var) {
-    u64 value = 0;
-    int shift = 0;
-
     if (in.IsFinished()) {
         var.m_Value = 0;
         return in;
     }
 
-    std::size_t i = in.GetReadOffset();
+    std::size_t offset = in.GetReadOffset();
+    std::size_t length = 0;
 
-    do {
-        if (i >= in.GetSize())
+    switch (TryReadVarInt(&in[offset], in.GetSize() - offset, var.m_Value, length)) {
+        case DecodeResult::Success:
+            break;
+        case DecodeResult::Incomplete:
             throw std::out_of_range("Failed reading VarInt from DataBuffer.");
-        value |= (u64)(in[i] & 0x7F) << shift;
-        shift += 7;
-    } while ((in[i++] & 0x80) != 0);
+        default:
+            throw std::runtime_error("Failed reading malformed VarInt from DataBuffer.");
+    }
+
+    in.SetReadOffset(offset + length);
+
+    return in;
+}
+
+DataBufferView& operator>>(DataBufferView& in, VarInt& var) {
+    if (in.IsFinished()) {
+        var.m_Value = 0;
+        return in;
+    }
+
+    switch (TryReadVarInt(in, var)) {
+        case DecodeResult::Success:
+            break;
+        case DecodeResult::Incomplete:
+            throw std::out_of_range("Failed reading VarInt from DataBufferView.");
+        default:
+            throw std::runtime_error("Failed reading malformed VarInt from DataBufferView.");
+    }
+
+    return in;
+}
 
-    in.SetReadOffset(i);
+namespace {
+
+// The fast decoder loads 8 bytes at once, so it needs a little endian host and a way to count trailing zeros.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define MCLIB_VARINT_FAST_DECODE
+
+inline std::size_t CountTrailingZeros(u64 value) {
+    return (std::size_t)__builtin_ctzll(value);
+}
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#define MCLIB_VARINT_FAST_DECODE
+
+inline std::size_t CountTrailingZeros(u64 value) {
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (std::size_t)index;
+}
+#endif
+
+#ifdef MCLIB_VARINT_FAST_DECODE
+// Packs the low 7 bits of each byte of word into one integer. The first byte ends up as the lowest bits.
+inline u64 PackVarIntGroups(u64 word) {
+    word &= 0x7F7F7F7F7F7F7F7FULL;
+    word = (word & 0x007F007F007F007FULL) | ((word & 0x7F007F007F007F00ULL) >> 1);
+    word = (word & 0x00003FFF00003FFFULL) | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+    word = (word & 0x000000000FFFFFFFULL) | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+    return word;
+}
+#endif
+
+template <typename T>
+DecodeResult TryReadVarIntImpl(const u8* data, std::size_t size, T& value, std::size_t& length) noexcept {
+    typedef typename std::make_unsigned<T>::type Unsigned;
+    // 7 bits of the value are stored in each byte.
+    const std::size_t MaxLength = (sizeof(T) * 8 + 6) / 7;
+
+    // Most VarInts are ids and small counts that fit in a single byte.
+    if (size > 0 && data[0] < 0x80) {
+        value = (T)data[0];
+        length = 1;
+        return DecodeResult::Success;
+    }
+
+#ifdef MCLIB_VARINT_FAST_DECODE
+    if (size >= sizeof(u64)) {
+        u64 word;
+        memcpy(&word, data, sizeof(word));
+
+        // The high bit of every byte except the last one is set.
+        u64 ends = ~word & 0x8080808080808080ULL;
+
+        if (ends != 0) {
+            std::size_t end = CountTrailingZeros(ends);
+            std::size_t count = end / 8 + 1;
+
+            if (count > MaxLength)
+                return DecodeResult::Malformed;
+
+            // Drop the bytes after the VarInt.
+            value = (T)(Unsigned)PackVarIntGroups(word & (~0ULL >> (63 - end)));
+            length = count;
+            return DecodeResult::Success;
+        }
+        // Longer than 8 bytes, which only VarLongs can be.
+    }
+#endif
+
+    Unsigned result = 0;
+
+    for (std::size_t i = 0; i < MaxLength; ++i) {
+        if (i >= size)
+            return DecodeResult::Incomplete;
+
+        result |= (Unsigned)(data[i] & 0x7F) << (7 * i);
+
+        if ((data[i] & 0x80) == 0) {
+            value = (T)result;
+            length = i + 1;
+            return DecodeResult::Success;
+        }
+    }
 
-    var.m_Value = value;
+    return DecodeResult::Malformed;
+}
+
+} // ns
+
+std::size_t WriteVarInt(u8* data, s64 value) noexcept {
+    u64 uval = (u64)value;
+    std::size_t length = 0;
+
+    while (uval >= 0x80) {
+        data[length++] = (u8)(uval | 0x80);
+        uval >>= 7;
+    }
+
+    data[length++] = (u8)uval;
+    return length;
+}
+
+DecodeResult TryReadVarInt(const u8* data, std::size_t size, s32& value, std::size_t& length) noexcept {
+    return TryReadVarIntImpl(data, size, value, length);
+}
+
+DecodeResult TryReadVarInt(const u8* data, std::size_t size, s64& value, std::size_t& length) noexcept {
+    return TryReadVarIntImpl(data, size, value, length);
+}
+
+DecodeResult TryReadVarInt(DataBufferView& in, VarInt& var) noexcept {
+    s64 value = 0;
+    std::size_t length = 0;
+
+    DecodeResult result = TryReadVarInt(in.GetReadPointer(), in.GetRemaining(), value, length);
+
+    if (result == DecodeResult::Success) {
+        var = VarInt(value);
+        in.SetReadOffset(in.GetReadOffset() + length);
+    }
+
+    return result;
+}
+
+DecodeResult TryReadVarInts(const u8* data, std::size_t size, s32* values, std::size_t count, std::size_t& length) noexcept {
+    std::size_t offset = 0;
+    std::size_t i = 0;
+
+#ifdef MCLIB_VARINT_FAST_DECODE
+    // Skips the per VarInt bounds checks while a whole word can be loaded.
+    for (; i < count && offset + sizeof(u64) <= size; ++i) {
+        if (data[offset] < 0x80) {
+            values[i] = data[offset++];
+            continue;
+        }
+
+        u64 word;
+        memcpy(&word, data + offset, sizeof(word));
+
+        std::size_t end = CountTrailingZeros((~word & 0x8080808080808080ULL) | (1ULL << 63));
+
+        // Longer than a VarInt can be, or not terminated within the word.
+        if (end >= 5 * 8)
+            return DecodeResult::Malformed;
+
+        values[i] = (s32)(u32)PackVarIntGroups(word & (~0ULL >> (63 - end)));
+        offset += end / 8 + 1;
+    }
+#endif
+
+    for (; i < count; ++i) {
+        std::size_t read = 0;
+        DecodeResult result = TryReadVarIntImpl(data + offset, size - offset, values[i], read);
+
+        if (result != DecodeResult::Success)
+            return result;
+
+        offset += read;
+    }
+
+    length = offset;
+    return DecodeResult::Success;
+}
+
+DataBuffer& ReadVarInts(DataBuffer& in, s32* values, std::size_t count) {
+    if (count == 0) return in;
+
+    std::size_t offset = in.GetReadOffset();
+    std::size_t length = 0;
+    const u8* data = in.IsFinished() ? nullptr : &in[offset];
+
+    switch (TryReadVarInts(data, in.GetSize() - offset, values, count, length)) {
+        case DecodeResult::Success:
+            break;
+        case DecodeResult::Incomplete:
+            throw std::out_of_range("Failed reading VarInts from DataBuffer.");
+        default:
+            throw std::runtime_error("Failed reading malformed VarInt from DataBuffer.");
+    }
+
+    in.SetReadOffset(offset + length);
+    return in;
+}
+
+DataBufferView& ReadVarInts(DataBufferView& in, s32* values, std::size_t count) {
+    std::size_t length = 0;
+
+    switch (TryReadVarInts(in.GetReadPointer(), in.GetRemaining(), values, count, length)) {
+        case DecodeResult::Success:
+            break;
+        case DecodeResult::Incomplete:
+            throw std::out_of_range("Failed reading VarInts from DataBufferView.");
+        default:
+            throw std::runtime_error("Failed reading malformed VarInt from DataBufferView.");
+    }
 
+    in.SetReadOffset(in.GetReadOffset() + length);
     return in;
 }
 
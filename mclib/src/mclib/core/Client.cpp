@@ -21,11 +21,13 @@ Client::Client(protocol::packets::PacketDispatcher* dispatcher, protocol::Versio
     m_PlayerManager(m_Dispatcher, &m_EntityManager),
     m_World(m_Dispatcher),
     m_PlayerController(std::make_unique<util::PlayerController>(&m_Connection, m_World, m_PlayerManager)),
+    m_Reactor(nullptr),
     m_LastUpdate(0),
     m_Connected(false),
     m_InventoryManager(std::make_unique<inventory::InventoryManager>(m_Dispatcher, &m_Connection)),
     m_Hotbar(m_Dispatcher, &m_Connection, m_InventoryManager.get())
 {
+    m_Connection.SetAutoFlush(false);
     m_Connection.RegisterListener(this);
 }
 
@@ -35,12 +37,32 @@ Client::~Client() {
     if (m_UpdateThread.joinable())
         m_UpdateThread.join();
     m_Connection.UnregisterListener(this);
+    if (m_Reactor)
+        m_Reactor->UnregisterListener(this);
 }
 
 void Client::OnSocketStateChange(network::Socket::Status newState) {
     m_Connected = (newState == network::Socket::Status::Connected);
 }
 
+void Client::OnPoll() {
+    if (m_Connected)
+        UpdateTick();
+}
+
+void Client::SetReactor(network::Reactor* reactor) {
+    if (reactor == m_Reactor) return;
+
+    if (m_Reactor)
+        m_Reactor->UnregisterListener(this);
+
+    m_Reactor = reactor;
+    m_Connection.SetReactor(reactor);
+
+    if (m_Reactor)
+        m_Reactor->RegisterListener(this);
+}
+
 void Client::Update() {
     try {
         m_Connection.CreatePacket();
@@ -48,6 +70,10 @@ void Client::Update() {
         std::wcout << e.what() << std::endl;
     }
 
+    UpdateTick();
+}
+
+void Client::UpdateTick() {
     entity::EntityPtr playerEntity = m_EntityManager.GetPlayerEntity();
     if (playerEntity) {
         // Keep entity manager and player controller in sync
@@ -60,6 +86,9 @@ void Client::Update() {
         NotifyListeners(&ClientListener::OnTick);
         m_LastUpdate = time;
     }
+
+    // Everything sent during this update goes out in a single batch.
+    m_Connection.Flush();
 }
 
 void Client::UpdateThread() {
@@ -77,7 +106,12 @@ bool Client::Login(const std::string& host, unsigned short port,
         m_UpdateThread.join();
     }
 
+    if (method == UpdateMethod::Reactor && m_Reactor == nullptr)
+        throw std::runtime_error("No reactor was set for the client");
+
     m_LastUpdate = 0;
+    // The settings can change after the client is created, so size the chunk map for the ones sent with this login.
+    m_World.SetViewDistance(m_Connection.GetSettings().GetViewDistance());
 
     if (!m_Connection.Connect(host, port))
         throw std::runtime_error("Could not connect to server");
@@ -101,7 +135,12 @@ bool Client::Login(const std::string& host, unsigned short port,
         m_UpdateThread.join();
     }
 
+    if (method == UpdateMethod::Reactor && m_Reactor == nullptr)
+        throw std::runtime_error("No reactor was set for the client");
+
     m_LastUpdate = 0;
+    // The settings can change after the client is created, so size the chunk map for the ones sent with this login.
+    m_World.SetViewDistance(m_Connection.GetSettings().GetViewDistance());
 
     if (!m_Connection.Connect(host, port))
         throw std::runtime_error("Could not connect to server");
@@ -123,6 +162,9 @@ void Client::Ping(const std::string& host, unsigned short port, UpdateMethod met
         m_UpdateThread.join();
     }
 
+    if (method == UpdateMethod::Reactor && m_Reactor == nullptr)
+        throw std::runtime_error("No reactor was set for the client");
+
     if (!m_Connection.Connect(host, port))
         throw std::runtime_error("Could not connect to server");
 
@@ -4,7 +4,10 @@
 
 #include <zlib.h>
 #include <cassert>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 namespace mc {
 namespace core {
@@ -19,29 +22,90 @@ DataBuffer CompressionNone::Compress(DataBuffer& buffer) {
     return packet;
 }
 
-DataBuffer CompressionNone::Decompress(DataBuffer& buffer, std::size_t packetLength) {
-    DataBuffer ret;
-    buffer.ReadSome(ret, packetLength);
+DataBufferView CompressionNone::Decompress(DataBufferView& frame, std::size_t packetLength) {
+    DataBufferView ret;
+    frame.ReadSome(ret, packetLength);
     return ret;
 }
 
-unsigned long inflate(const std::string& source, std::string& dest) {
-    unsigned long size = dest.size();
-    uncompress((Bytef*)&dest[0], &size, (const Bytef*)source.c_str(), source.length());
-    return size;
-}
+// Largest uncompressed packet accepted. Keeps a bad length from allocating huge buffers.
+const std::size_t MaxUncompressedSize = 8 * 1024 * 1024;
+
+class CompressionZ::Impl {
+private:
+    z_stream m_Deflater;
+    z_stream m_Inflater;
+
+public:
+    std::vector<u8> m_Deflated;
+    std::vector<u8> m_Inflated;
+
+    Impl(s32 level) {
+        memset(&m_Deflater, 0, sizeof(m_Deflater));
+        memset(&m_Inflater, 0, sizeof(m_Inflater));
+
+        if (deflateInit(&m_Deflater, level) != Z_OK)
+            throw std::runtime_error("Failed to initialize deflate stream.");
+
+        if (inflateInit(&m_Inflater) != Z_OK) {
+            deflateEnd(&m_Deflater);
+            throw std::runtime_error("Failed to initialize inflate stream.");
+        }
+    }
+
+    ~Impl() {
+        deflateEnd(&m_Deflater);
+        inflateEnd(&m_Inflater);
+    }
+
+    // Deflates into m_Deflated and returns the compressed size.
+    std::size_t Deflate(const u8* data, std::size_t size) {
+        deflateReset(&m_Deflater);
+
+        // deflateBound is large enough for incompressible data too, so one call always finishes.
+        std::size_t bound = deflateBound(&m_Deflater, (uLong)size);
+        if (m_Deflated.size() < bound)
+            m_Deflated.resize(bound);
+
+        m_Deflater.next_in = const_cast<Bytef*>(data);
+        m_Deflater.avail_in = (uInt)size;
+        m_Deflater.next_out = m_Deflated.data();
+        m_Deflater.avail_out = (uInt)m_Deflated.size();
+
+        if (::deflate(&m_Deflater, Z_FINISH) != Z_STREAM_END)
+            throw std::runtime_error("Failed to deflate packet.");
+
+        return m_Deflater.total_out;
+    }
+
+    // Inflates into m_Inflated, which is resized to uncompressedSize.
+    void Inflate(const u8* data, std::size_t size, std::size_t uncompressedSize) {
+        inflateReset(&m_Inflater);
+
+        m_Inflated.resize(uncompressedSize);
+
+        m_Inflater.next_in = const_cast<Bytef*>(data);
+        m_Inflater.avail_in = (uInt)size;
+        m_Inflater.next_out = m_Inflated.data();
+        m_Inflater.avail_out = (uInt)uncompressedSize;
+
+        if (::inflate(&m_Inflater, Z_FINISH) != Z_STREAM_END || m_Inflater.total_out != uncompressedSize)
+            throw std::runtime_error("Failed to inflate packet.");
+    }
+};
+
+CompressionZ::CompressionZ(u64 threshold, s32 level)
+    : m_Impl(new Impl(level)),
+      m_CompressionThreshold(threshold)
+{
 
-unsigned long deflate(const std::string& source, std::string& dest) {
-    unsigned long size = source.length();
-    dest.resize(size);
+}
 
-    compress((Bytef*)&dest[0], &size, (const Bytef*)source.c_str(), source.length());
-    dest.resize(size);
-    return size;
+CompressionZ::~CompressionZ() {
+    delete m_Impl;
 }
 
 DataBuffer CompressionZ::Compress(DataBuffer& buffer) {
-    std::string compressedData;
     DataBuffer packet;
 
     if (buffer.GetSize() < m_CompressionThreshold) {
@@ -49,51 +113,50 @@ DataBuffer CompressionZ::Compress(DataBuffer& buffer) {
         VarInt dataLength(0);
         VarInt packetLength((s32)(buffer.GetSize() + dataLength.GetSerializedLength()));
 
+        packet.Reserve(packetLength.GetSerializedLength() + packetLength.GetInt());
         packet << packetLength;
         packet << dataLength;
         packet << buffer;
         return packet;
     }
 
-
-    deflate(buffer.ToString(), compressedData);
+    std::size_t compressedSize = m_Impl->Deflate(&buffer[0], buffer.GetSize());
 
     VarInt dataLength((s32)buffer.GetSize());
-    VarInt packetLength((s32)(compressedData.length() + dataLength.GetSerializedLength()));
+    VarInt packetLength((s32)(compressedSize + dataLength.GetSerializedLength()));
 
+    packet.Reserve(packetLength.GetSerializedLength() + packetLength.GetInt());
     packet << packetLength;
     packet << dataLength;
-    packet << compressedData;
+
+    std::size_t offset = packet.GetSize();
+    packet.Resize(offset + compressedSize);
+    memcpy(&packet[offset], m_Impl->m_Deflated.data(), compressedSize);
     return packet;
 }
 
-DataBuffer CompressionZ::Decompress(DataBuffer& buffer, std::size_t packetLength) {
+DataBufferView CompressionZ::Decompress(DataBufferView& frame, std::size_t packetLength) {
     VarInt uncompressedLength;
 
-    buffer >> uncompressedLength;
+    std::size_t begin = frame.GetReadOffset();
+    frame >> uncompressedLength;
+
+    std::size_t compressedLength = packetLength - (frame.GetReadOffset() - begin);
 
-    std::size_t compressedLength = packetLength - uncompressedLength.GetSerializedLength();
+    DataBufferView compressed;
+    frame.ReadSome(compressed, compressedLength);
 
     if (uncompressedLength.GetInt() == 0) {
         // Uncompressed
-        DataBuffer ret;
-        buffer.ReadSome(ret, compressedLength);
-        return ret;
+        return compressed;
     }
 
+    if (uncompressedLength.GetInt() < 0 || (std::size_t)uncompressedLength.GetInt() > MaxUncompressedSize)
+        throw std::runtime_error("Received packet with an invalid uncompressed length.");
 
-    assert(buffer.GetReadOffset() + compressedLength <= buffer.GetSize());
-
-    std::string deflatedData;
-    buffer.ReadSome(deflatedData, compressedLength);
-
-    std::string inflated;
-    inflated.resize(uncompressedLength.GetInt());
-
-    inflate(deflatedData, inflated);
+    m_Impl->Inflate(compressed.GetReadPointer(), compressedLength, uncompressedLength.GetInt());
 
-    assert(inflated.length() == uncompressedLength.GetInt());
-    return DataBuffer(inflated);
+    return DataBufferView(m_Impl->m_Inflated.data(), m_Impl->m_Inflated.size());
 }
 
 } // ns core
@@ -14,6 +14,16 @@
 #include <memory>
 #include <iostream>
 
+namespace {
+
+// Minimum amount of space made available at the end of the receive buffer for each recv.
+const std::size_t ReceiveSize = 4096;
+
+const std::size_t DefaultSendLowWatermark = 256 * 1024;
+const std::size_t DefaultSendHighWatermark = 1024 * 1024;
+
+} // ns
+
 namespace mc {
 namespace core {
 
@@ -23,9 +33,16 @@ Connection::Connection(protocol::packets::PacketDispatcher* dispatcher, protocol
     m_Compressor(std::make_unique<CompressionNone>()),
     m_Socket(std::make_unique<network::TCPSocket>()),
     m_Yggdrasil(std::make_unique<util::Yggdrasil>()),
+    m_Reactor(nullptr),
+    m_ReactorHandle(INVALID_SOCKET),
+    m_SendLowWatermark(DefaultSendLowWatermark),
+    m_SendHighWatermark(DefaultSendHighWatermark),
     m_Protocol(protocol::Protocol::GetProtocol(version)),
     m_SentSettings(false),
-    m_Dimension(1)
+    m_AutoFlush(true),
+    m_Backpressure(false),
+    m_Dimension(1),
+    m_CompressionLevel(CompressionZ::DefaultLevel)
 {
     dispatcher->RegisterHandler(protocol::State::Login, protocol::login::Disconnect, this);
     dispatcher->RegisterHandler(protocol::State::Login, protocol::login::EncryptionRequest, this);
@@ -43,6 +60,7 @@ Connection::Connection(protocol::packets::PacketDispatcher* dispatcher, protocol
 }
 
 Connection::~Connection() {
+    UnregisterFromReactor();
     GetDispatcher()->UnregisterHandler(this);
 }
 
@@ -50,6 +68,47 @@ network::Socket::Status Connection::GetSocketState() const {
     return m_Socket->GetStatus();
 }
 
+void Connection::SetReactor(network::Reactor* reactor) {
+    if (reactor == m_Reactor) return;
+
+    UnregisterFromReactor();
+    m_Reactor = reactor;
+    RegisterWithReactor();
+}
+
+void Connection::RegisterWithReactor() {
+    if (m_Reactor == nullptr || m_Socket->GetStatus() != network::Socket::Connected) return;
+
+    if (m_Reactor->Register(m_Socket->GetHandle(), this))
+        m_ReactorHandle = m_Socket->GetHandle();
+}
+
+void Connection::UnregisterFromReactor() {
+    if (m_Reactor && m_ReactorHandle != INVALID_SOCKET)
+        m_Reactor->Unregister(m_ReactorHandle);
+
+    m_ReactorHandle = INVALID_SOCKET;
+}
+
+void Connection::OnReadable() {
+    try {
+        CreatePacket();
+    } catch (std::exception& e) {
+        std::wcout << e.what() << std::endl;
+    }
+
+    // The handle is closed on disconnect and could be reused by another socket.
+    if (m_Socket->GetStatus() != network::Socket::Connected)
+        UnregisterFromReactor();
+}
+
+void Connection::OnWritable() {
+    Flush();
+
+    if (m_Socket->GetStatus() != network::Socket::Connected)
+        UnregisterFromReactor();
+}
+
 void Connection::HandlePacket(protocol::packets::in::JoinGamePacket* packet) {
     m_Dimension = packet->GetDimension();
 }
@@ -160,12 +219,13 @@ void Connection::HandlePacket(protocol::packets::in::LoginSuccessPacket* packet)
 }
 
 void Connection::HandlePacket(protocol::packets::in::SetCompressionPacket* packet) {
-    m_Compressor = std::make_unique<CompressionZ>(packet->GetMaxPacketSize());
+    m_Compressor = std::make_unique<CompressionZ>(packet->GetMaxPacketSize(), m_CompressionLevel);
 }
 
 bool Connection::Connect(const std::string& server, u16 port) {
     bool result = false;
 
+    UnregisterFromReactor();
     m_Socket = std::make_unique<network::TCPSocket>();
     m_Yggdrasil = std::unique_ptr<util::Yggdrasil>(new util::Yggdrasil());
     m_ProtocolState = protocol::State::Handshake;
@@ -173,6 +233,9 @@ bool Connection::Connect(const std::string& server, u16 port) {
 
     m_Compressor = std::make_unique<CompressionNone>();
     m_Encrypter = std::make_unique<EncryptionStrategyNone>();
+    m_ReceiveBuffer.Clear();
+    m_SendBuffer.Clear();
+    m_Backpressure = false;
 
     m_Server = server;
     m_Port = port;
@@ -195,80 +258,136 @@ bool Connection::Connect(const std::string& server, u16 port) {
 
     m_Socket->SetBlocking(false);
 
-    if (result)
+    if (result) {
+        RegisterWithReactor();
         NotifyListeners(&ConnectionListener::OnSocketStateChange, m_Socket->GetStatus());
+    }
 
     return result;
 }
 
 void Connection::Disconnect() {
+    UnregisterFromReactor();
     m_Socket->Disconnect();
     NotifyListeners(&ConnectionListener::OnSocketStateChange, m_Socket->GetStatus());
 }
 
-protocol::packets::Packet* Connection::CreatePacket(DataBuffer& buffer) {
-    std::size_t readOffset = buffer.GetReadOffset();
-    VarInt length;
+void Connection::Flush() {
+    if (m_SendBuffer.IsEmpty()) return;
 
-    try {
-        buffer >> length;
-    } catch (const std::out_of_range&) {
-        // This will happen when the buffer only contains part of the VarInt, 
-        // so only part of the packet was received so far.
-        // The buffer read offset isn't advanced when the exception is thrown, so no need to set it back to what it was.
-        return nullptr;
+    if (m_Socket->GetStatus() != network::Socket::Connected) {
+        m_SendBuffer.Clear();
+        return;
     }
 
-    if (length.GetInt() == 0 || buffer.GetRemaining() < (u32)length.GetInt()) {
-        // Reset the read offset back to what it was because the full packet hasn't been received yet.
-        buffer.SetReadOffset(readOffset);
-        return nullptr;
+    // The queued frames are contiguous so the whole batch goes out in one send.
+    std::size_t sent = m_Socket->Send(m_SendBuffer.GetReadPointer(), m_SendBuffer.GetSize());
+
+    if (m_Socket->GetStatus() != network::Socket::Connected) {
+        m_SendBuffer.Clear();
+        NotifyListeners(&ConnectionListener::OnSocketStateChange, m_Socket->GetStatus());
+        return;
     }
 
-    DataBuffer decompressed = m_Compressor->Decompress(buffer, length.GetInt());
+    // Anything the socket didn't accept stays queued as the backlog.
+    m_SendBuffer.Consume(sent);
+    UpdateSendState();
+}
+
+void Connection::UpdateSendState() {
+    std::size_t backlog = m_SendBuffer.GetSize();
+
+    if (m_Reactor && m_ReactorHandle != INVALID_SOCKET) {
+        u32 events = network::Reactor::Readable;
+
+        if (backlog > 0)
+            events |= network::Reactor::Writable;
 
-    return protocol::packets::PacketFactory::CreatePacket(m_Protocol, m_ProtocolState, decompressed, length.GetInt(), this);
+        m_Reactor->Modify(m_ReactorHandle, events);
+    }
+
+    if (!m_Backpressure && backlog >= m_SendHighWatermark) {
+        m_Backpressure = true;
+        NotifyListeners(&ConnectionListener::OnBackpressure, true);
+    } else if (m_Backpressure && backlog <= m_SendLowWatermark) {
+        m_Backpressure = false;
+        NotifyListeners(&ConnectionListener::OnBackpressure, false);
+    }
+}
+
+bool Connection::ProcessFrame() {
+    s32 length = 0;
+    std::size_t prefixSize = 0;
+
+    DecodeResult result = TryReadVarInt(m_ReceiveBuffer.GetReadPointer(), m_ReceiveBuffer.GetSize(), length, prefixSize);
+
+    if (result == DecodeResult::Incomplete)
+        return false;
+
+    if (result == DecodeResult::Malformed)
+        throw std::runtime_error("Received frame with an invalid length prefix.");
+
+    if (length < 0)
+        throw std::runtime_error("Received frame with a negative length.");
+
+    std::size_t frameSize = prefixSize + length;
+
+    if (m_ReceiveBuffer.GetSize() < frameSize) {
+        // Make room for the whole frame now so the rest of it is received in place.
+        m_ReceiveBuffer.Reserve(frameSize);
+        return false;
+    }
+
+    DataBufferView frame(m_ReceiveBuffer.GetReadPointer() + prefixSize, length);
+
+    // Consume the frame before handling it so a bad packet can't stall the stream.
+    // The frame memory stays valid since the buffer only moves data when more is received.
+    m_ReceiveBuffer.Consume(frameSize);
+
+    if (length == 0) return true;
+
+    DataBufferView payload = m_Compressor->Decompress(frame, length);
+    if (payload.IsEmpty()) return true;
+
+    protocol::packets::Packet* packet = nullptr;
+
+    result = protocol::packets::PacketFactory::TryCreatePacket(m_Protocol, m_ProtocolState, payload, length, this, packet);
+
+    // Packets that mclib doesn't know yet are skipped like the ones nothing handles.
+    if (result == DecodeResult::Malformed)
+        throw std::runtime_error("Received packet with an invalid id.");
+
+    if (packet) {
+        // Only send the settings after the server has accepted the new protocol state.
+        if (!m_SentSettings && packet->GetProtocolState() == protocol::State::Play) {
+            SendSettingsPacket();
+        }
+
+        this->GetDispatcher()->Dispatch(packet);
+        protocol::packets::PacketFactory::FreePacket(packet);
+    }
+
+    return true;
 }
 
 void Connection::CreatePacket() {
     while (true) {
-        DataBuffer buffer;
+        u8* data = m_ReceiveBuffer.PrepareWrite(ReceiveSize);
+        std::size_t received = m_Socket->Receive(data, m_ReceiveBuffer.GetWritable());
 
-        m_Socket->Receive(buffer, 4096);
-
-        if (buffer.IsEmpty()) {
+        if (received == 0) {
             if (m_Socket->GetStatus() != network::Socket::Connected) {
                 NotifyListeners(&ConnectionListener::OnSocketStateChange, m_Socket->GetStatus());
             }
             return;
         }
 
-        m_HandleBuffer << m_Encrypter->Decrypt(buffer);
-
-        do {
-            try {
-                protocol::packets::Packet* packet = CreatePacket(m_HandleBuffer);
-
-                if (packet) {
-                    // Only send the settings after the server has accepted the new protocol state.
-                    if (!m_SentSettings && packet->GetProtocolState() == protocol::State::Play) {
-                        SendSettingsPacket();
-                    }
-
-                    this->GetDispatcher()->Dispatch(packet);
-                    protocol::packets::PacketFactory::FreePacket(packet);
-                } else {
-                    break;
-                }
-            } catch (const protocol::UnfinishedProtocolException&) {
-                // Ignore for now
-            }
-        } while (!m_HandleBuffer.IsFinished() && m_HandleBuffer.GetSize() > 0);
+        m_Encrypter->Decrypt(data, received);
+
+        m_ReceiveBuffer.CommitWrite(received);
 
-        if (m_HandleBuffer.IsFinished())
-            m_HandleBuffer = DataBuffer();
-        else if (m_HandleBuffer.GetReadOffset() != 0)
-            m_HandleBuffer = DataBuffer(m_HandleBuffer, m_HandleBuffer.GetReadOffset());
+        while (ProcessFrame())
+            ;
 
         if (m_Socket->GetStatus() != network::Socket::Connected) {
             NotifyListeners(&ConnectionListener::OnSocketStateChange, m_Socket->GetStatus());
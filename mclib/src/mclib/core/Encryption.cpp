@@ -32,12 +32,22 @@ public:
     }
 };
 
-DataBuffer EncryptionStrategyNone::Encrypt(const DataBuffer& buffer) {
-    return buffer;
+DataBuffer EncryptionStrategy::Encrypt(const DataBuffer& buffer) {
+    DataBuffer result(buffer);
+
+    if (!result.IsEmpty())
+        Encrypt(&result[0], result.GetSize());
+
+    return result;
 }
 
-DataBuffer EncryptionStrategyNone::Decrypt(const DataBuffer& buffer) {
-    return buffer;
+DataBuffer EncryptionStrategy::Decrypt(const DataBuffer& buffer) {
+    DataBuffer result(buffer);
+
+    if (!result.IsEmpty())
+        Decrypt(&result[0], result.GetSize());
+
+    return result;
 }
 
 class EncryptionStrategyAES::Impl {
@@ -45,7 +55,6 @@ private:
     RandomGenerator m_RNG;
     EVP_CIPHER_CTX* m_EncryptCTX;
     EVP_CIPHER_CTX* m_DecryptCTX;
-    unsigned int m_BlockSize;
 
     protocol::packets::out::EncryptionResponsePacket* m_ResponsePacket;
 
@@ -100,8 +109,6 @@ private:
         if (!(EVP_DecryptInit_ex(m_DecryptCTX, EVP_aes_128_cfb8(), nullptr, m_SharedSecret.key, m_SharedSecret.key)))
             return false;
 
-        m_BlockSize = EVP_CIPHER_block_size(EVP_aes_128_cfb8());
-
         m_ResponsePacket = new protocol::packets::out::EncryptionResponsePacket(encryptedSS, encryptedToken);
         return true;
     }
@@ -125,26 +132,15 @@ public:
         m_DecryptCTX = nullptr;
     }
 
-    DataBuffer encrypt(const DataBuffer& buffer) {
-        DataBuffer result;
-        int size = 0;
-
-        result.Resize(buffer.GetSize() + m_BlockSize);
-        EVP_EncryptUpdate(m_EncryptCTX, &result[0], &size, &buffer[0], buffer.GetSize());
-        result.Resize(size);
-
-        return result;
+    // CFB8 is a stream mode, so the output is the same size as the input and can overwrite it.
+    void encrypt(u8* data, std::size_t size) {
+        int outSize = 0;
+        EVP_EncryptUpdate(m_EncryptCTX, data, &outSize, data, (int)size);
     }
 
-    DataBuffer decrypt(const DataBuffer& buffer) {
-        DataBuffer result;
-        int size = 0;
-
-        result.Resize(buffer.GetSize() + m_BlockSize);
-        EVP_DecryptUpdate(m_DecryptCTX, &result[0], &size, &buffer[0], buffer.GetSize());
-        result.Resize(size);
-
-        return result;
+    void decrypt(u8* data, std::size_t size) {
+        int outSize = 0;
+        EVP_DecryptUpdate(m_DecryptCTX, data, &outSize, data, (int)size);
     }
 
     std::string GetSharedSecret() const {
@@ -164,12 +160,12 @@ EncryptionStrategyAES::~EncryptionStrategyAES() {
     delete m_Impl;
 }
 
-DataBuffer EncryptionStrategyAES::Encrypt(const DataBuffer& buffer) {
-    return m_Impl->encrypt(buffer);
+void EncryptionStrategyAES::Encrypt(u8* data, std::size_t size) {
+    m_Impl->encrypt(data, size);
 }
 
-DataBuffer EncryptionStrategyAES::Decrypt(const DataBuffer& buffer) {
-    return m_Impl->decrypt(buffer);
+void EncryptionStrategyAES::Decrypt(u8* data, std::size_t size) {
+    m_Impl->decrypt(data, size);
 }
 
 std::string EncryptionStrategyAES::GetSharedSecret() const {
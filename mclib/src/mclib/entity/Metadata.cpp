@@ -287,7 +287,7 @@ DataBuffer& operator>>(DataBuffer& in, EntityMetadata& md) {
             break;
             case EntityMetadata::DataType::Position:
             {
-                std::unique_ptr<EntityMetadata::PositionType> value = std::make_unique<EntityMetadata::PositionType>();
+                std::unique_ptr<EntityMetadata::PositionType> value = std::make_unique<EntityMetadata::PositionType>(false, Position(md.m_ProtocolVersion));
                 in >> *value;
                 value->exists = true;
                 md.m_Metadata[index].first = std::move(value);
@@ -295,7 +295,7 @@ DataBuffer& operator>>(DataBuffer& in, EntityMetadata& md) {
             break;
             case EntityMetadata::DataType::OptPosition:
             {
-                std::unique_ptr<EntityMetadata::PositionType> value = std::make_unique<EntityMetadata::PositionType>();
+                std::unique_ptr<EntityMetadata::PositionType> value = std::make_unique<EntityMetadata::PositionType>(false, Position(md.m_ProtocolVersion));
                 in >> value->exists;
                 if (value->exists) {
                     in >> *value;
@@ -162,13 +162,11 @@ void TagIntArray::Read(DataBuffer& buffer) {
 
   buffer >> length;
 
-  m_Value.clear();
+  if (length < 0 || (std::size_t)length > buffer.GetRemaining() / sizeof(s32))
+    throw std::runtime_error("Invalid NBT array length.");
 
-  for (s32 i = 0; i < length; ++i) {
-    s32 val;
-    buffer >> val;
-    m_Value.push_back(val);
-  }
+  m_Value.resize(length);
+  buffer.ReadBigEndianArray(m_Value.data(), m_Value.size());
 }
 
 TagType TagLongArray::GetType() const noexcept {
@@ -188,13 +186,11 @@ void TagLongArray::Read(DataBuffer& buffer) {
 
   buffer >> length;
 
-  m_Value.clear();
+  if (length < 0 || (std::size_t)length > buffer.GetRemaining() / sizeof(s64))
+    throw std::runtime_error("Invalid NBT array length.");
 
-  for (s32 i = 0; i < length; ++i) {
-    s64 val;
-    buffer >> val;
-    m_Value.push_back(val);
-  }
+  m_Value.resize(length);
+  buffer.ReadBigEndianArray(m_Value.data(), m_Value.size());
 }
 
 void TagList::Write(DataBuffer& buffer) const {
@@ -0,0 +1,203 @@
+#include <mclib/network/Reactor.h>
+
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <cerrno>
+#elif !defined(_WIN32)
+#include <poll.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+const int MaxEvents = 256;
+
+u32 ToEpollEvents(u32 events) {
+    u32 result = 0;
+
+    if (events & mc::network::Reactor::Readable)
+        result |= EPOLLIN;
+    if (events & mc::network::Reactor::Writable)
+        result |= EPOLLOUT;
+
+    return result;
+}
+
+#else
+
+#ifdef _WIN32
+typedef WSAPOLLFD PollDescriptor;
+
+int PollSockets(PollDescriptor* fds, std::size_t count, int timeout) {
+    return WSAPoll(fds, (ULONG)count, timeout);
+}
+#else
+typedef pollfd PollDescriptor;
+
+int PollSockets(PollDescriptor* fds, std::size_t count, int timeout) {
+    return poll(fds, (nfds_t)count, timeout);
+}
+#endif
+
+#endif
+
+} // ns
+
+namespace mc {
+namespace network {
+
+Reactor::Reactor()
+    : m_Running(false)
+{
+#ifdef __linux__
+    m_EpollHandle = epoll_create1(EPOLL_CLOEXEC);
+
+    if (m_EpollHandle < 0)
+        throw std::runtime_error("Failed to create epoll instance.");
+#endif
+}
+
+Reactor::~Reactor() {
+#ifdef __linux__
+    close(m_EpollHandle);
+#endif
+}
+
+bool Reactor::Register(SocketHandle handle, ReactorHandler* handler, u32 events) {
+    if (handle == INVALID_SOCKET || handler == nullptr) return false;
+
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = ToEpollEvents(events);
+    event.data.fd = handle;
+
+    if (epoll_ctl(m_EpollHandle, EPOLL_CTL_ADD, handle, &event) != 0) {
+        // Already registered, or the handle was reused before the old registration was removed.
+        if (errno != EEXIST || epoll_ctl(m_EpollHandle, EPOLL_CTL_MOD, handle, &event) != 0)
+            return false;
+    }
+#endif
+
+    m_Registrations[handle] = Registration{ handler, events };
+    return true;
+}
+
+bool Reactor::Modify(SocketHandle handle, u32 events) {
+    auto iter = m_Registrations.find(handle);
+    if (iter == m_Registrations.end()) return false;
+
+    if (iter->second.events == events) return true;
+
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = ToEpollEvents(events);
+    event.data.fd = handle;
+
+    if (epoll_ctl(m_EpollHandle, EPOLL_CTL_MOD, handle, &event) != 0)
+        return false;
+#endif
+
+    iter->second.events = events;
+    return true;
+}
+
+void Reactor::Unregister(SocketHandle handle) {
+    if (m_Registrations.erase(handle) == 0) return;
+
+#ifdef __linux__
+    // Closed sockets are removed from epoll automatically, so this is allowed to fail.
+    epoll_event event = {};
+    epoll_ctl(m_EpollHandle, EPOLL_CTL_DEL, handle, &event);
+#endif
+}
+
+std::size_t Reactor::Poll(s32 timeout) {
+    std::size_t handled = 0;
+
+    auto dispatch = [this, &handled](SocketHandle handle, bool readable, bool writable) {
+        auto iter = m_Registrations.find(handle);
+        // Unregistered by an earlier handler during this poll
+        if (iter == m_Registrations.end()) return;
+
+        ReactorHandler* handler = iter->second.handler;
+
+        ++handled;
+
+        if (readable)
+            handler->OnReadable();
+
+        if (writable) {
+            // OnReadable can disconnect and unregister the handler.
+            iter = m_Registrations.find(handle);
+            if (iter != m_Registrations.end() && iter->second.handler == handler)
+                handler->OnWritable();
+        }
+    };
+
+#ifdef __linux__
+    epoll_event events[MaxEvents];
+
+    int count = epoll_wait(m_EpollHandle, events, MaxEvents, timeout);
+
+    for (int i = 0; i < count; ++i) {
+        u32 flags = events[i].events;
+
+        // Errors and hangups are reported as readable so the handler notices them on recv.
+        bool readable = (flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+        bool writable = (flags & EPOLLOUT) != 0;
+
+        dispatch(events[i].data.fd, readable, writable);
+    }
+#else
+    std::vector<PollDescriptor> descriptors;
+    descriptors.reserve(m_Registrations.size());
+
+    for (const auto& kv : m_Registrations) {
+        PollDescriptor descriptor = {};
+
+        descriptor.fd = kv.first;
+        if (kv.second.events & Readable)
+            descriptor.events |= POLLIN;
+        if (kv.second.events & Writable)
+            descriptor.events |= POLLOUT;
+
+        descriptors.push_back(descriptor);
+    }
+
+    if (descriptors.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+    } else if (PollSockets(&descriptors[0], descriptors.size(), timeout) > 0) {
+        for (const PollDescriptor& descriptor : descriptors) {
+            if (descriptor.revents == 0) continue;
+
+            bool readable = (descriptor.revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+            bool writable = (descriptor.revents & POLLOUT) != 0;
+
+            dispatch(descriptor.fd, readable, writable);
+        }
+    }
+#endif
+
+    NotifyListeners(&ReactorListener::OnPoll);
+
+    return handled;
+}
+
+void Reactor::Run(s32 timeout) {
+    m_Running = true;
+
+    while (m_Running)
+        Poll(timeout);
+}
+
+void Reactor::Stop() {
+    m_Running = false;
+}
+
+} // ns network
+} // ns mc
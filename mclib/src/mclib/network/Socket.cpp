@@ -29,9 +29,9 @@ void Socket::SetBlocking(bool block) {
     int opts = fcntl(m_Handle, F_GETFL);
     if (opts < 0) return;
     if (block)
-        opts |= O_NONBLOCK;
-    else
         opts &= ~O_NONBLOCK;
+    else
+        opts |= O_NONBLOCK;
     fcntl(m_Handle, F_SETFL, opts);
 #endif
 
@@ -0,0 +1,77 @@
+#include <mclib/network/StreamBuffer.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace mc {
+namespace network {
+
+StreamBuffer::StreamBuffer(std::size_t initialCapacity)
+    : m_Buffer(initialCapacity),
+      m_ReadOffset(0),
+      m_WriteOffset(0)
+{
+
+}
+
+void StreamBuffer::Compact() {
+    if (m_ReadOffset == 0) return;
+
+    std::size_t size = GetSize();
+
+    if (size > 0)
+        memmove(&m_Buffer[0], &m_Buffer[m_ReadOffset], size);
+
+    m_ReadOffset = 0;
+    m_WriteOffset = size;
+}
+
+u8* StreamBuffer::PrepareWrite(std::size_t amount) {
+    if (GetWritable() < amount) {
+        // Reclaim consumed space first. This only moves the unread tail.
+        Compact();
+
+        if (GetWritable() < amount)
+            m_Buffer.resize(std::max(m_Buffer.size() * 2, m_WriteOffset + amount));
+    }
+
+    return GetWritePointer();
+}
+
+void StreamBuffer::CommitWrite(std::size_t amount) {
+    assert(m_WriteOffset + amount <= m_Buffer.size());
+    m_WriteOffset += amount;
+}
+
+void StreamBuffer::Write(const u8* data, std::size_t size) {
+    if (size == 0) return;
+
+    memcpy(PrepareWrite(size), data, size);
+    m_WriteOffset += size;
+}
+
+void StreamBuffer::Reserve(std::size_t size) {
+    if (m_ReadOffset + size <= m_Buffer.size()) return;
+
+    Compact();
+
+    if (size > m_Buffer.size())
+        m_Buffer.resize(size);
+}
+
+void StreamBuffer::Consume(std::size_t amount) {
+    assert(amount <= GetSize());
+    m_ReadOffset += amount;
+
+    // Rewind for free when everything was read.
+    if (m_ReadOffset == m_WriteOffset)
+        m_ReadOffset = m_WriteOffset = 0;
+}
+
+void StreamBuffer::Clear() {
+    m_ReadOffset = m_WriteOffset = 0;
+}
+
+} // ns network
+} // ns mc
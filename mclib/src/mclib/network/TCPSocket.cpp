@@ -11,6 +11,13 @@
 #define WOULDBLOCK EWOULDBLOCK
 #endif
 
+#ifdef MSG_NOSIGNAL
+// Report a closed connection as an error instead of raising SIGPIPE.
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
 namespace mc {
 namespace network {
 
@@ -63,8 +70,17 @@ size_t TCPSocket::Send(const unsigned char* data, size_t size) {
     size_t sent = 0;
 
     while (sent < size) {
-        int cur = ::send(m_Handle, reinterpret_cast<const char*>(data + sent), size - sent, 0);
+        int cur = ::send(m_Handle, reinterpret_cast<const char*>(data + sent), size - sent, SEND_FLAGS);
         if (cur <= 0) {
+#if defined(_WIN32) || defined(WIN32)
+            int err = WSAGetLastError();
+#else
+            int err = errno;
+#endif
+            // The send buffer is full. The caller keeps the rest and tries again later.
+            if (cur < 0 && err == WOULDBLOCK)
+                break;
+
             Disconnect();
             return 0;
         }
@@ -78,23 +94,26 @@ std::size_t TCPSocket::Receive(DataBuffer& buffer, std::size_t amount) {
     buffer.Resize(amount);
     buffer.SetReadOffset(0);
 
-    int recvAmount = recv(m_Handle, (char*)&buffer[0], amount, MSG_DONTWAIT);
+    std::size_t recvAmount = Receive(&buffer[0], amount);
+
+    buffer.Resize(recvAmount);
+    return recvAmount;
+}
+
+std::size_t TCPSocket::Receive(u8* buffer, std::size_t amount) {
+    int recvAmount = recv(m_Handle, (char*)buffer, amount, MSG_DONTWAIT);
     if (recvAmount <= 0) {
 #if defined(_WIN32) || defined(WIN32)
         int err = WSAGetLastError();
 #else
         int err = errno;
 #endif
-        if (err == WOULDBLOCK) {
-            buffer.Clear();
+        if (recvAmount < 0 && err == WOULDBLOCK)
             return 0;
-        }
 
         Disconnect();
-        buffer.Clear();
         return 0;
     }
-    buffer.Resize(recvAmount);
     return recvAmount;
 }
 
@@ -2,402 +2,418 @@
 
 #include <mclib/protocol/packets/Packet.h>
 
+#include <initializer_list>
+
 namespace mc {
 namespace protocol {
 
-class Protocol_1_12_0 : public Protocol {
-public:
-    Protocol_1_12_0(Version version, StateMap inbound)
-        : Protocol(version, inbound)
-    {
+namespace {
 
-    }
+struct OutboundEntry {
+    outbound::ProtocolOutbound packet;
+    s32 id;
+};
+
+constexpr OutboundTable MakeOutboundTable(std::initializer_list<OutboundEntry> entries) {
+    OutboundTable table = {};
+
+    for (s32& id : table.ids)
+        id = -1;
+
+    for (const OutboundEntry& entry : entries)
+        table.ids[entry.packet] = entry.id;
+
+    return table;
+}
+
+} // ns
 
+// 1.10.2 to 1.11.2
+constexpr OutboundTable outbound_1_11_2 = MakeOutboundTable({
     // Handshake
-    virtual s32 GetPacketId(packets::out::HandshakePacket) override { return 0x00; }
+    { outbound::Handshake, 0x00 },
 
     // Login
-    virtual s32 GetPacketId(packets::out::LoginStartPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::EncryptionResponsePacket) override { return 0x01; }
+    { outbound::LoginStart, 0x00 },
+    { outbound::EncryptionResponse, 0x01 },
 
     // Status
-    virtual s32 GetPacketId(packets::out::status::RequestPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::status::PingPacket) override { return 0x01; }
+    { outbound::StatusRequest, 0x00 },
+    { outbound::StatusPing, 0x01 },
 
     // Play
-    virtual s32 GetPacketId(packets::out::TeleportConfirmPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::PrepareCraftingGridPacket) override { return 0x01; }
-    virtual s32 GetPacketId(packets::out::TabCompletePacket) override { return 0x02; }
-    virtual s32 GetPacketId(packets::out::ChatPacket) override { return 0x03; }
-    virtual s32 GetPacketId(packets::out::ClientStatusPacket) override { return 0x04; }
-    virtual s32 GetPacketId(packets::out::ClientSettingsPacket) override { return 0x05; }
-    virtual s32 GetPacketId(packets::out::ConfirmTransactionPacket) override { return 0x06; }
-    virtual s32 GetPacketId(packets::out::EnchantItemPacket) override { return 0x07; }
-    virtual s32 GetPacketId(packets::out::ClickWindowPacket) override { return 0x08; }
-    virtual s32 GetPacketId(packets::out::CloseWindowPacket) override { return 0x09; }
-    virtual s32 GetPacketId(packets::out::PluginMessagePacket) override { return 0x0A; }
-    virtual s32 GetPacketId(packets::out::UseEntityPacket) override { return 0x0B; }
-    virtual s32 GetPacketId(packets::out::KeepAlivePacket) override { return 0x0C; }
-    virtual s32 GetPacketId(packets::out::PlayerPacket) override { return 0x0D; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionPacket) override { return 0x0E; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionAndLookPacket) override { return 0x0F; }
-    virtual s32 GetPacketId(packets::out::PlayerLookPacket) override { return 0x10; }
-    virtual s32 GetPacketId(packets::out::VehicleMovePacket) override { return 0x11; }
-    virtual s32 GetPacketId(packets::out::SteerBoatPacket) override { return 0x12; }
-    virtual s32 GetPacketId(packets::out::PlayerAbilitiesPacket) override { return 0x13; }
-    virtual s32 GetPacketId(packets::out::PlayerDiggingPacket) override { return 0x14; }
-    virtual s32 GetPacketId(packets::out::EntityActionPacket) override { return 0x15; }
-    virtual s32 GetPacketId(packets::out::SteerVehiclePacket) override { return 0x16; }
-    virtual s32 GetPacketId(packets::out::CraftingBookDataPacket) override { return 0x17; }
-    virtual s32 GetPacketId(packets::out::ResourcePackStatusPacket) override { return 0x18; }
-    virtual s32 GetPacketId(packets::out::AdvancementTabPacket) override { return 0x19; }
-    virtual s32 GetPacketId(packets::out::HeldItemChangePacket) override { return 0x1A; }
-    virtual s32 GetPacketId(packets::out::CreativeInventoryActionPacket) override { return 0x1B; }
-    virtual s32 GetPacketId(packets::out::UpdateSignPacket) override { return 0x1C; }
-    virtual s32 GetPacketId(packets::out::AnimationPacket) override { return 0x1D; }
-    virtual s32 GetPacketId(packets::out::SpectatePacket) override { return 0x1E; }
-    virtual s32 GetPacketId(packets::out::PlayerBlockPlacementPacket) override { return 0x1F; }
-    virtual s32 GetPacketId(packets::out::UseItemPacket) override { return 0x20; }
-};
-
-class Protocol_1_12_1 : public Protocol {
-public:
-    Protocol_1_12_1(Version version, StateMap inbound)
-        : Protocol(version, inbound)
-    {
-
-    }
-
+    { outbound::TeleportConfirm, 0x00 },
+    { outbound::TabComplete, 0x01 },
+    { outbound::Chat, 0x02 },
+    { outbound::ClientStatus, 0x03 },
+    { outbound::ClientSettings, 0x04 },
+    { outbound::ConfirmTransaction, 0x05 },
+    { outbound::EnchantItem, 0x06 },
+    { outbound::ClickWindow, 0x07 },
+    { outbound::CloseWindow, 0x08 },
+    { outbound::PluginMessage, 0x09 },
+    { outbound::UseEntity, 0x0A },
+    { outbound::KeepAlive, 0x0B },
+    { outbound::PlayerPosition, 0x0C },
+    { outbound::PlayerPositionAndLook, 0x0D },
+    { outbound::PlayerLook, 0x0E },
+    { outbound::Player, 0x0F },
+    { outbound::VehicleMove, 0x10 },
+    { outbound::SteerBoat, 0x11 },
+    { outbound::PlayerAbilities, 0x12 },
+    { outbound::PlayerDigging, 0x13 },
+    { outbound::EntityAction, 0x14 },
+    { outbound::SteerVehicle, 0x15 },
+    { outbound::ResourcePackStatus, 0x16 },
+    { outbound::HeldItemChange, 0x17 },
+    { outbound::CreativeInventoryAction, 0x18 },
+    { outbound::UpdateSign, 0x19 },
+    { outbound::Animation, 0x1A },
+    { outbound::Spectate, 0x1B },
+    { outbound::PlayerBlockPlacement, 0x1C },
+    { outbound::UseItem, 0x1D },
+});
+
+constexpr OutboundTable outbound_1_12_0 = MakeOutboundTable({
     // Handshake
-    virtual s32 GetPacketId(packets::out::HandshakePacket) override { return 0x00; }
+    { outbound::Handshake, 0x00 },
 
     // Login
-    virtual s32 GetPacketId(packets::out::LoginStartPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::EncryptionResponsePacket) override { return 0x01; }
+    { outbound::LoginStart, 0x00 },
+    { outbound::EncryptionResponse, 0x01 },
 
     // Status
-    virtual s32 GetPacketId(packets::out::status::RequestPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::status::PingPacket) override { return 0x01; }
+    { outbound::StatusRequest, 0x00 },
+    { outbound::StatusPing, 0x01 },
 
     // Play
-    virtual s32 GetPacketId(packets::out::TeleportConfirmPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::TabCompletePacket) override { return 0x01; }
-    virtual s32 GetPacketId(packets::out::ChatPacket) override { return 0x02; }
-    virtual s32 GetPacketId(packets::out::ClientStatusPacket) override { return 0x03; }
-    virtual s32 GetPacketId(packets::out::ClientSettingsPacket) override { return 0x04; }
-    virtual s32 GetPacketId(packets::out::ConfirmTransactionPacket) override { return 0x05; }
-    virtual s32 GetPacketId(packets::out::EnchantItemPacket) override { return 0x06; }
-    virtual s32 GetPacketId(packets::out::ClickWindowPacket) override { return 0x07; }
-    virtual s32 GetPacketId(packets::out::CloseWindowPacket) override { return 0x08; }
-    virtual s32 GetPacketId(packets::out::PluginMessagePacket) override { return 0x09; }
-    virtual s32 GetPacketId(packets::out::UseEntityPacket) override { return 0x0A; }
-    virtual s32 GetPacketId(packets::out::KeepAlivePacket) override { return 0x0B; }
-    virtual s32 GetPacketId(packets::out::PlayerPacket) override { return 0x0C; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionPacket) override { return 0x0D; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionAndLookPacket) override { return 0x0E; }
-    virtual s32 GetPacketId(packets::out::PlayerLookPacket) override { return 0x0F; }
-    virtual s32 GetPacketId(packets::out::VehicleMovePacket) override { return 0x10; }
-    virtual s32 GetPacketId(packets::out::SteerBoatPacket) override { return 0x11; }
-    virtual s32 GetPacketId(packets::out::CraftRecipeRequestPacket) override { return 0x12; }
-    virtual s32 GetPacketId(packets::out::PlayerAbilitiesPacket) override { return 0x13; }
-    virtual s32 GetPacketId(packets::out::PlayerDiggingPacket) override { return 0x14; }
-    virtual s32 GetPacketId(packets::out::EntityActionPacket) override { return 0x15; }
-    virtual s32 GetPacketId(packets::out::SteerVehiclePacket) override { return 0x16; }
-    virtual s32 GetPacketId(packets::out::CraftingBookDataPacket) override { return 0x17; }
-    virtual s32 GetPacketId(packets::out::ResourcePackStatusPacket) override { return 0x18; }
-    virtual s32 GetPacketId(packets::out::AdvancementTabPacket) override { return 0x19; }
-    virtual s32 GetPacketId(packets::out::HeldItemChangePacket) override { return 0x1A; }
-    virtual s32 GetPacketId(packets::out::CreativeInventoryActionPacket) override { return 0x1B; }
-    virtual s32 GetPacketId(packets::out::UpdateSignPacket) override { return 0x1C; }
-    virtual s32 GetPacketId(packets::out::AnimationPacket) override { return 0x1D; }
-    virtual s32 GetPacketId(packets::out::SpectatePacket) override { return 0x1E; }
-    virtual s32 GetPacketId(packets::out::PlayerBlockPlacementPacket) override { return 0x1F; }
-    virtual s32 GetPacketId(packets::out::UseItemPacket) override { return 0x20; }
-
-    virtual s32 GetPacketId(packets::out::PrepareCraftingGridPacket) override { throw UnsupportedPacketException("PrepareCraftingGridPacket does not work with protocol 1.12.1"); }
-};
-
+    { outbound::TeleportConfirm, 0x00 },
+    { outbound::PrepareCraftingGrid, 0x01 },
+    { outbound::TabComplete, 0x02 },
+    { outbound::Chat, 0x03 },
+    { outbound::ClientStatus, 0x04 },
+    { outbound::ClientSettings, 0x05 },
+    { outbound::ConfirmTransaction, 0x06 },
+    { outbound::EnchantItem, 0x07 },
+    { outbound::ClickWindow, 0x08 },
+    { outbound::CloseWindow, 0x09 },
+    { outbound::PluginMessage, 0x0A },
+    { outbound::UseEntity, 0x0B },
+    { outbound::KeepAlive, 0x0C },
+    { outbound::Player, 0x0D },
+    { outbound::PlayerPosition, 0x0E },
+    { outbound::PlayerPositionAndLook, 0x0F },
+    { outbound::PlayerLook, 0x10 },
+    { outbound::VehicleMove, 0x11 },
+    { outbound::SteerBoat, 0x12 },
+    { outbound::PlayerAbilities, 0x13 },
+    { outbound::PlayerDigging, 0x14 },
+    { outbound::EntityAction, 0x15 },
+    { outbound::SteerVehicle, 0x16 },
+    { outbound::CraftingBookData, 0x17 },
+    { outbound::ResourcePackStatus, 0x18 },
+    { outbound::AdvancementTab, 0x19 },
+    { outbound::HeldItemChange, 0x1A },
+    { outbound::CreativeInventoryAction, 0x1B },
+    { outbound::UpdateSign, 0x1C },
+    { outbound::Animation, 0x1D },
+    { outbound::Spectate, 0x1E },
+    { outbound::PlayerBlockPlacement, 0x1F },
+    { outbound::UseItem, 0x20 },
+});
+
+constexpr OutboundTable outbound_1_12_1 = MakeOutboundTable({
+    // Handshake
+    { outbound::Handshake, 0x00 },
 
-class Protocol_1_13_2 : public Protocol {
-public:
-    Protocol_1_13_2(Version version, StateMap inbound)
-        : Protocol(version, inbound)
-    {
+    // Login
+    { outbound::LoginStart, 0x00 },
+    { outbound::EncryptionResponse, 0x01 },
 
-    }
+    // Status
+    { outbound::StatusRequest, 0x00 },
+    { outbound::StatusPing, 0x01 },
 
+    // Play
+    { outbound::TeleportConfirm, 0x00 },
+    { outbound::TabComplete, 0x01 },
+    { outbound::Chat, 0x02 },
+    { outbound::ClientStatus, 0x03 },
+    { outbound::ClientSettings, 0x04 },
+    { outbound::ConfirmTransaction, 0x05 },
+    { outbound::EnchantItem, 0x06 },
+    { outbound::ClickWindow, 0x07 },
+    { outbound::CloseWindow, 0x08 },
+    { outbound::PluginMessage, 0x09 },
+    { outbound::UseEntity, 0x0A },
+    { outbound::KeepAlive, 0x0B },
+    { outbound::Player, 0x0C },
+    { outbound::PlayerPosition, 0x0D },
+    { outbound::PlayerPositionAndLook, 0x0E },
+    { outbound::PlayerLook, 0x0F },
+    { outbound::VehicleMove, 0x10 },
+    { outbound::SteerBoat, 0x11 },
+    { outbound::CraftRecipeRequest, 0x12 },
+    { outbound::PlayerAbilities, 0x13 },
+    { outbound::PlayerDigging, 0x14 },
+    { outbound::EntityAction, 0x15 },
+    { outbound::SteerVehicle, 0x16 },
+    { outbound::CraftingBookData, 0x17 },
+    { outbound::ResourcePackStatus, 0x18 },
+    { outbound::AdvancementTab, 0x19 },
+    { outbound::HeldItemChange, 0x1A },
+    { outbound::CreativeInventoryAction, 0x1B },
+    { outbound::UpdateSign, 0x1C },
+    { outbound::Animation, 0x1D },
+    { outbound::Spectate, 0x1E },
+    { outbound::PlayerBlockPlacement, 0x1F },
+    { outbound::UseItem, 0x20 },
+});
+
+constexpr OutboundTable outbound_1_13_2 = MakeOutboundTable({
     // Handshake
-    virtual s32 GetPacketId(packets::out::HandshakePacket) override { return 0x00; }
+    { outbound::Handshake, 0x00 },
 
     // Login
-    virtual s32 GetPacketId(packets::out::LoginStartPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::EncryptionResponsePacket) override { return 0x01; }
+    { outbound::LoginStart, 0x00 },
+    { outbound::EncryptionResponse, 0x01 },
 
     // Status
-    virtual s32 GetPacketId(packets::out::status::RequestPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::status::PingPacket) override { return 0x01; }
+    { outbound::StatusRequest, 0x00 },
+    { outbound::StatusPing, 0x01 },
 
     // Play
-    virtual s32 GetPacketId(packets::out::TeleportConfirmPacket) override { return 0x00; }
+    { outbound::TeleportConfirm, 0x00 },
     // QueryBlockNBT = 0x01
-    virtual s32 GetPacketId(packets::out::ChatPacket) override { return 0x02; }
-    virtual s32 GetPacketId(packets::out::ClientStatusPacket) override { return 0x03; }
-    virtual s32 GetPacketId(packets::out::ClientSettingsPacket) override { return 0x04; }
-    virtual s32 GetPacketId(packets::out::TabCompletePacket) override { return 0x05; }
-    virtual s32 GetPacketId(packets::out::ConfirmTransactionPacket) override { return 0x06; }
-    virtual s32 GetPacketId(packets::out::EnchantItemPacket) override { return 0x07; }
-    virtual s32 GetPacketId(packets::out::ClickWindowPacket) override { return 0x08; }
-    virtual s32 GetPacketId(packets::out::CloseWindowPacket) override { return 0x09; }
-    virtual s32 GetPacketId(packets::out::PluginMessagePacket) override { return 0x0A; }
+    { outbound::Chat, 0x02 },
+    { outbound::ClientStatus, 0x03 },
+    { outbound::ClientSettings, 0x04 },
+    { outbound::TabComplete, 0x05 },
+    { outbound::ConfirmTransaction, 0x06 },
+    { outbound::EnchantItem, 0x07 },
+    { outbound::ClickWindow, 0x08 },
+    { outbound::CloseWindow, 0x09 },
+    { outbound::PluginMessage, 0x0A },
     // EditBook = 0x0B
     // QueryEntityNBT = 0x0C
-    virtual s32 GetPacketId(packets::out::UseEntityPacket) override { return 0x0D; }
-    virtual s32 GetPacketId(packets::out::KeepAlivePacket) override { return 0x0E; }
-    virtual s32 GetPacketId(packets::out::PlayerPacket) override { return 0x0F; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionPacket) override { return 0x10; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionAndLookPacket) override { return 0x11; }
-    virtual s32 GetPacketId(packets::out::PlayerLookPacket) override { return 0x12; }
-    virtual s32 GetPacketId(packets::out::VehicleMovePacket) override { return 0x13; }
-    virtual s32 GetPacketId(packets::out::SteerBoatPacket) override { return 0x14; }
+    { outbound::UseEntity, 0x0D },
+    { outbound::KeepAlive, 0x0E },
+    { outbound::Player, 0x0F },
+    { outbound::PlayerPosition, 0x10 },
+    { outbound::PlayerPositionAndLook, 0x11 },
+    { outbound::PlayerLook, 0x12 },
+    { outbound::VehicleMove, 0x13 },
+    { outbound::SteerBoat, 0x14 },
     // PickItem = 0x15
-    virtual s32 GetPacketId(packets::out::CraftRecipeRequestPacket) override { return 0x16; }
-    virtual s32 GetPacketId(packets::out::PlayerAbilitiesPacket) override { return 0x17; }
-    virtual s32 GetPacketId(packets::out::PlayerDiggingPacket) override { return 0x18; }
-    virtual s32 GetPacketId(packets::out::EntityActionPacket) override { return 0x19; }
-    virtual s32 GetPacketId(packets::out::SteerVehiclePacket) override { return 0x1A; }
-    virtual s32 GetPacketId(packets::out::CraftingBookDataPacket) override { return 0x1B; }
+    { outbound::CraftRecipeRequest, 0x16 },
+    { outbound::PlayerAbilities, 0x17 },
+    { outbound::PlayerDigging, 0x18 },
+    { outbound::EntityAction, 0x19 },
+    { outbound::SteerVehicle, 0x1A },
+    { outbound::CraftingBookData, 0x1B },
     // NameItem = 0x1C
-    virtual s32 GetPacketId(packets::out::ResourcePackStatusPacket) override { return 0x1D; }
-    virtual s32 GetPacketId(packets::out::AdvancementTabPacket) override { return 0x1E; }
+    { outbound::ResourcePackStatus, 0x1D },
+    { outbound::AdvancementTab, 0x1E },
     // SelectTrade = 0x1F
     // SetBeaconEffect = 0x20
-    virtual s32 GetPacketId(packets::out::HeldItemChangePacket) override { return 0x21; }
+    { outbound::HeldItemChange, 0x21 },
     // UpdateCommandBlock = 0x22
     // UpdateCommandBlockMinecart = 0x23
-    virtual s32 GetPacketId(packets::out::CreativeInventoryActionPacket) override { return 0x24; }
+    { outbound::CreativeInventoryAction, 0x24 },
     // UpdateStructure = 0x25
-    virtual s32 GetPacketId(packets::out::UpdateSignPacket) override { return 0x26; }
-    virtual s32 GetPacketId(packets::out::AnimationPacket) override { return 0x27; }
-    virtual s32 GetPacketId(packets::out::SpectatePacket) override { return 0x28; }
-    virtual s32 GetPacketId(packets::out::PlayerBlockPlacementPacket) override { return 0x29; }
-    virtual s32 GetPacketId(packets::out::UseItemPacket) override { return 0x2A; }
-
-    virtual s32 GetPacketId(packets::out::PrepareCraftingGridPacket) override { throw UnsupportedPacketException("PrepareCraftingGridPacket does not work with protocol 1.13.2"); }
-};
-
-class Protocol_1_14_2 : public Protocol {
-public:
-    Protocol_1_14_2(Version version, StateMap inbound)
-        : Protocol(version, inbound)
-    {
-
-    }
-
+    { outbound::UpdateSign, 0x26 },
+    { outbound::Animation, 0x27 },
+    { outbound::Spectate, 0x28 },
+    { outbound::PlayerBlockPlacement, 0x29 },
+    { outbound::UseItem, 0x2A },
+});
+
+constexpr OutboundTable outbound_1_14_2 = MakeOutboundTable({
     // Handshake
-    virtual s32 GetPacketId(packets::out::HandshakePacket) override { return 0x00; }
+    { outbound::Handshake, 0x00 },
 
     // Login
-    virtual s32 GetPacketId(packets::out::LoginStartPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::EncryptionResponsePacket) override { return 0x01; }
+    { outbound::LoginStart, 0x00 },
+    { outbound::EncryptionResponse, 0x01 },
 
     // Status
-    virtual s32 GetPacketId(packets::out::status::RequestPacket) override { return 0x00; }
-    virtual s32 GetPacketId(packets::out::status::PingPacket) override { return 0x01; }
+    { outbound::StatusRequest, 0x00 },
+    { outbound::StatusPing, 0x01 },
 
     // Play
-    virtual s32 GetPacketId(packets::out::TeleportConfirmPacket) override { return 0x00; }
+    { outbound::TeleportConfirm, 0x00 },
     // QueryBlockNBT = 0x01
     // SetDifficulty = 0x02
-    virtual s32 GetPacketId(packets::out::ChatPacket) override { return 0x03; }
-    virtual s32 GetPacketId(packets::out::ClientStatusPacket) override { return 0x04; }
-    virtual s32 GetPacketId(packets::out::ClientSettingsPacket) override { return 0x05; }
-    virtual s32 GetPacketId(packets::out::TabCompletePacket) override { return 0x06; }
-    virtual s32 GetPacketId(packets::out::ConfirmTransactionPacket) override { return 0x07; }
-    // ClickWindowButton = 0x08
-    virtual s32 GetPacketId(packets::out::ClickWindowPacket) override { return 0x09; }
-    virtual s32 GetPacketId(packets::out::CloseWindowPacket) override { return 0x0A; }
-    virtual s32 GetPacketId(packets::out::PluginMessagePacket) override { return 0x0B; }
+    { outbound::Chat, 0x03 },
+    { outbound::ClientStatus, 0x04 },
+    { outbound::ClientSettings, 0x05 },
+    { outbound::TabComplete, 0x06 },
+    { outbound::ConfirmTransaction, 0x07 },
+    { outbound::EnchantItem, 0x08 }, // = ClickWindowButton now
+    { outbound::ClickWindow, 0x09 },
+    { outbound::CloseWindow, 0x0A },
+    { outbound::PluginMessage, 0x0B },
     // EditBook = 0x0B
     // QueryEntityNBT = 0x0C
-    virtual s32 GetPacketId(packets::out::UseEntityPacket) override { return 0x0E; }
-    virtual s32 GetPacketId(packets::out::KeepAlivePacket) override { return 0x0F; }
+    { outbound::UseEntity, 0x0E },
+    { outbound::KeepAlive, 0x0F },
     // LockDifficulty = 0x10
-    virtual s32 GetPacketId(packets::out::PlayerPositionPacket) override { return 0x11; }
-    virtual s32 GetPacketId(packets::out::PlayerPositionAndLookPacket) override { return 0x12; }
-    virtual s32 GetPacketId(packets::out::PlayerLookPacket) override { return 0x13; }
-    virtual s32 GetPacketId(packets::out::PlayerPacket) override { return 0x14; }
-    virtual s32 GetPacketId(packets::out::VehicleMovePacket) override { return 0x15; }
-    virtual s32 GetPacketId(packets::out::SteerBoatPacket) override { return 0x16; }
+    { outbound::PlayerPosition, 0x11 },
+    { outbound::PlayerPositionAndLook, 0x12 },
+    { outbound::PlayerLook, 0x13 },
+    { outbound::Player, 0x14 },
+    { outbound::VehicleMove, 0x15 },
+    { outbound::SteerBoat, 0x16 },
     // PickItem = 0x17
-    virtual s32 GetPacketId(packets::out::CraftRecipeRequestPacket) override { return 0x18; }
-    virtual s32 GetPacketId(packets::out::PlayerAbilitiesPacket) override { return 0x19; }
-    virtual s32 GetPacketId(packets::out::PlayerDiggingPacket) override { return 0x1A; }
-    virtual s32 GetPacketId(packets::out::EntityActionPacket) override { return 0x1B; }
-    virtual s32 GetPacketId(packets::out::SteerVehiclePacket) override { return 0x1C; }
-    virtual s32 GetPacketId(packets::out::CraftingBookDataPacket) override { return 0x1D; }
+    { outbound::CraftRecipeRequest, 0x18 },
+    { outbound::PlayerAbilities, 0x19 },
+    { outbound::PlayerDigging, 0x1A },
+    { outbound::EntityAction, 0x1B },
+    { outbound::SteerVehicle, 0x1C },
+    { outbound::CraftingBookData, 0x1D },
     // NameItem = 0x1E
-    virtual s32 GetPacketId(packets::out::ResourcePackStatusPacket) override { return 0x1F; }
-    virtual s32 GetPacketId(packets::out::AdvancementTabPacket) override { return 0x20; }
+    { outbound::ResourcePackStatus, 0x1F },
+    { outbound::AdvancementTab, 0x20 },
     // SelectTrade = 0x21
     // SetBeaconEffect = 0x22
-    virtual s32 GetPacketId(packets::out::HeldItemChangePacket) override { return 0x23; }
+    { outbound::HeldItemChange, 0x23 },
     // UpdateCommandBlock = 0x24
     // UpdateCommandBlockMinecart = 0x25
-    virtual s32 GetPacketId(packets::out::CreativeInventoryActionPacket) override { return 0x26; }
+    { outbound::CreativeInventoryAction, 0x26 },
     // UpdateJigsaw = 0x27
     // UpdateStructure = 0x28
-    virtual s32 GetPacketId(packets::out::UpdateSignPacket) override { return 0x29; }
-    virtual s32 GetPacketId(packets::out::AnimationPacket) override { return 0x2A; }
-    virtual s32 GetPacketId(packets::out::SpectatePacket) override { return 0x2B; }
-    virtual s32 GetPacketId(packets::out::PlayerBlockPlacementPacket) override { return 0x2C; }
-    virtual s32 GetPacketId(packets::out::UseItemPacket) override { return 0x2D; }
+    { outbound::UpdateSign, 0x29 },
+    { outbound::Animation, 0x2A },
+    { outbound::Spectate, 0x2B },
+    { outbound::PlayerBlockPlacement, 0x2C },
+    { outbound::UseItem, 0x2D },
+});
+
+constexpr OutboundTable outbound_1_15_2 = MakeOutboundTable({
+    // Handshake
+    { outbound::Handshake, 0x00 },
 
-    virtual s32 GetPacketId(packets::out::PrepareCraftingGridPacket) override { throw UnsupportedPacketException("PrepareCraftingGridPacket does not work with protocol 1.13.2"); }
-};
+    // Login
+    { outbound::LoginStart, 0x00 },
+    { outbound::EncryptionResponse, 0x01 },
+    { outbound::LoginPluginResponse, 0x02 },
 
-class Protocol_1_15_2 : public Protocol {
-public:
-  Protocol_1_15_2(Version version, StateMap inbound)
-    : Protocol(version, inbound)
-  {
-
-  }
-
-  // Handshake
-  virtual s32 GetPacketId(packets::out::HandshakePacket) override { return 0x00; }
-
-  // Login
-  virtual s32 GetPacketId(packets::out::LoginStartPacket) override { return 0x00; }
-  virtual s32 GetPacketId(packets::out::EncryptionResponsePacket) override { return 0x01; }
-  virtual s32 GetPacketId(packets::out::LoginPluginResponsePacket) override { return 0x02; }
-
-  // Status
-  virtual s32 GetPacketId(packets::out::status::RequestPacket) override { return 0x00; }
-  virtual s32 GetPacketId(packets::out::status::PingPacket) override { return 0x01; }
-
-  // Play
-  virtual s32 GetPacketId(packets::out::TeleportConfirmPacket) override { return 0x00; }
-  // QueryBlockNBT = 0x01
-  // SetDifficulty = 0x02
-  virtual s32 GetPacketId(packets::out::ChatPacket) override { return 0x03; }
-  virtual s32 GetPacketId(packets::out::ClientStatusPacket) override { return 0x04; }
-  virtual s32 GetPacketId(packets::out::ClientSettingsPacket) override { return 0x05; }
-  virtual s32 GetPacketId(packets::out::TabCompletePacket) override { return 0x06; }
-  virtual s32 GetPacketId(packets::out::ConfirmTransactionPacket) override { return 0x07; }
-  virtual s32 GetPacketId(packets::out::EnchantItemPacket) override { return 0x08; } // = ClickWindowButton now
-  virtual s32 GetPacketId(packets::out::ClickWindowPacket) override { return 0x09; }
-  virtual s32 GetPacketId(packets::out::CloseWindowPacket) override { return 0x0A; }
-  virtual s32 GetPacketId(packets::out::PluginMessagePacket) override { return 0x0B; }
-  // EditBook = 0x0C
-  // QueryEntityNBT = 0x0D
-  virtual s32 GetPacketId(packets::out::UseEntityPacket) override { return 0x0E; }
-  virtual s32 GetPacketId(packets::out::KeepAlivePacket) override { return 0x0F; }
-  // LockDifficulty = 0x10
-  virtual s32 GetPacketId(packets::out::PlayerPositionPacket) override { return 0x11; }
-  virtual s32 GetPacketId(packets::out::PlayerPositionAndLookPacket) override { return 0x12; }
-  virtual s32 GetPacketId(packets::out::PlayerLookPacket) override { return 0x13; }
-  virtual s32 GetPacketId(packets::out::PlayerPacket) override { return 0x14; }
-  virtual s32 GetPacketId(packets::out::VehicleMovePacket) override { return 0x15; }
-  virtual s32 GetPacketId(packets::out::SteerBoatPacket) override { return 0x16; }
-  // PickItem = 0x17
-  virtual s32 GetPacketId(packets::out::CraftRecipeRequestPacket) override { return 0x18; }
-  virtual s32 GetPacketId(packets::out::PlayerAbilitiesPacket) override { return 0x19; }
-  virtual s32 GetPacketId(packets::out::PlayerDiggingPacket) override { return 0x1A; }
-  virtual s32 GetPacketId(packets::out::EntityActionPacket) override { return 0x1B; }
-  virtual s32 GetPacketId(packets::out::SteerVehiclePacket) override { return 0x1C; }
-  virtual s32 GetPacketId(packets::out::CraftingBookDataPacket) override { return 0x1D; }
-  // NameItem = 0x1E
-  virtual s32 GetPacketId(packets::out::ResourcePackStatusPacket) override { return 0x1F; }
-  virtual s32 GetPacketId(packets::out::AdvancementTabPacket) override { return 0x20; }
-  // SelectTrade = 0x21
-  // SetBeaconEffect = 0x22
-  virtual s32 GetPacketId(packets::out::HeldItemChangePacket) override { return 0x23; }
-  // UpdateCommandBlock = 0x24
-  // UpdateCommandBlockMinecart = 0x25
-  virtual s32 GetPacketId(packets::out::CreativeInventoryActionPacket) override { return 0x26; }
-  // UpdateJigsawBlock = 0x27
-  // UpdateStructure = 0x28
-  virtual s32 GetPacketId(packets::out::UpdateSignPacket) override { return 0x29; }
-  virtual s32 GetPacketId(packets::out::AnimationPacket) override { return 0x2A; }
-  virtual s32 GetPacketId(packets::out::SpectatePacket) override { return 0x2B; }
-  virtual s32 GetPacketId(packets::out::PlayerBlockPlacementPacket) override { return 0x2C; }
-  virtual s32 GetPacketId(packets::out::UseItemPacket) override { return 0x2D; }
-
-  virtual s32 GetPacketId(packets::out::PrepareCraftingGridPacket) override { throw UnsupportedPacketException("PrepareCraftingGridPacket does not work with protocol 1.15.2"); }
-};
+    // Status
+    { outbound::StatusRequest, 0x00 },
+    { outbound::StatusPing, 0x01 },
 
-class Protocol_1_16_5 : public Protocol {
-public:
-  Protocol_1_16_5(Version version, StateMap inbound)
-    : Protocol(version, inbound)
-  {
-
-  }
-
-  // Handshake
-  virtual s32 GetPacketId(packets::out::HandshakePacket) override { return 0x00; }
-
-  // Login
-  virtual s32 GetPacketId(packets::out::LoginStartPacket) override { return 0x00; }
-  virtual s32 GetPacketId(packets::out::EncryptionResponsePacket) override { return 0x01; }
-  virtual s32 GetPacketId(packets::out::LoginPluginResponsePacket) override { return 0x02; }
-
-  // Status
-  virtual s32 GetPacketId(packets::out::status::RequestPacket) override { return 0x00; }
-  virtual s32 GetPacketId(packets::out::status::PingPacket) override { return 0x01; }
-
-  // Play
-  virtual s32 GetPacketId(packets::out::TeleportConfirmPacket) override { return 0x00; }
-  // QueryBlockNBT = 0x01
-  // SetDifficulty = 0x02
-  virtual s32 GetPacketId(packets::out::ChatPacket) override { return 0x03; }
-  virtual s32 GetPacketId(packets::out::ClientStatusPacket) override { return 0x04; }
-  virtual s32 GetPacketId(packets::out::ClientSettingsPacket) override { return 0x05; }
-  virtual s32 GetPacketId(packets::out::TabCompletePacket) override { return 0x06; }
-  virtual s32 GetPacketId(packets::out::ConfirmTransactionPacket) override { return 0x07; }
-  virtual s32 GetPacketId(packets::out::EnchantItemPacket) override { return 0x08; } // = ClickWindowButton now
-  virtual s32 GetPacketId(packets::out::ClickWindowPacket) override { return 0x09; }
-  virtual s32 GetPacketId(packets::out::CloseWindowPacket) override { return 0x0A; }
-  virtual s32 GetPacketId(packets::out::PluginMessagePacket) override { return 0x0B; }
-  // EditBook = 0x0C
-  // QueryEntityNBT = 0x0D
-  // Generate Structure = 0x0F
-  virtual s32 GetPacketId(packets::out::UseEntityPacket) override { return 0x0E; }
-  virtual s32 GetPacketId(packets::out::KeepAlivePacket) override { return 0x10; }
-  // LockDifficulty = 0x11
-  virtual s32 GetPacketId(packets::out::PlayerPositionPacket) override { return 0x12; }
-  virtual s32 GetPacketId(packets::out::PlayerPositionAndLookPacket) override { return 0x13; }
-  virtual s32 GetPacketId(packets::out::PlayerLookPacket) override { return 0x14; }
-  virtual s32 GetPacketId(packets::out::PlayerPacket) override { return 0x15; }
-  virtual s32 GetPacketId(packets::out::VehicleMovePacket) override { return 0x16; }
-  virtual s32 GetPacketId(packets::out::SteerBoatPacket) override { return 0x17; }
-  // PickItem = 0x18
-  virtual s32 GetPacketId(packets::out::CraftRecipeRequestPacket) override { return 0x19; }
-  virtual s32 GetPacketId(packets::out::PlayerAbilitiesPacket) override { return 0x1A; }
-  virtual s32 GetPacketId(packets::out::PlayerDiggingPacket) override { return 0x1B; }
-  virtual s32 GetPacketId(packets::out::EntityActionPacket) override { return 0x1C; }
-  virtual s32 GetPacketId(packets::out::SteerVehiclePacket) override { return 0x1D; }
-  // DisplayedRecipe = 0x1E
-  // RecipeBookState = 0x1F
-  // NameItem = 0x20
-  virtual s32 GetPacketId(packets::out::ResourcePackStatusPacket) override { return 0x21; }
-  virtual s32 GetPacketId(packets::out::AdvancementTabPacket) override { return 0x22; }
-  // SelectTrade = 0x23
-  // SetBeaconEffect = 0x24
-  virtual s32 GetPacketId(packets::out::HeldItemChangePacket) override { return 0x25; }
-  // UpdateCommandBlock = 0x26
-  // UpdateCommandBlockMinecart = 0x27
-  virtual s32 GetPacketId(packets::out::CreativeInventoryActionPacket) override { return 0x28; }
-  // UpdateJigsawBlock = 0x29
-  // UpdateStructure = 0x2A
-  virtual s32 GetPacketId(packets::out::UpdateSignPacket) override { return 0x2B; }
-  virtual s32 GetPacketId(packets::out::AnimationPacket) override { return 0x2C; }
-  virtual s32 GetPacketId(packets::out::SpectatePacket) override { return 0x2D; }
-  virtual s32 GetPacketId(packets::out::PlayerBlockPlacementPacket) override { return 0x2E; }
-  virtual s32 GetPacketId(packets::out::UseItemPacket) override { return 0x2F; }
-
-  virtual s32 GetPacketId(packets::out::PrepareCraftingGridPacket) override { throw UnsupportedPacketException("PrepareCraftingGridPacket does not work with protocol 1.16"); }
-};
+    // Play
+    { outbound::TeleportConfirm, 0x00 },
+    // QueryBlockNBT = 0x01
+    // SetDifficulty = 0x02
+    { outbound::Chat, 0x03 },
+    { outbound::ClientStatus, 0x04 },
+    { outbound::ClientSettings, 0x05 },
+    { outbound::TabComplete, 0x06 },
+    { outbound::ConfirmTransaction, 0x07 },
+    { outbound::EnchantItem, 0x08 }, // = ClickWindowButton now
+    { outbound::ClickWindow, 0x09 },
+    { outbound::CloseWindow, 0x0A },
+    { outbound::PluginMessage, 0x0B },
+    // EditBook = 0x0C
+    // QueryEntityNBT = 0x0D
+    { outbound::UseEntity, 0x0E },
+    { outbound::KeepAlive, 0x0F },
+    // LockDifficulty = 0x10
+    { outbound::PlayerPosition, 0x11 },
+    { outbound::PlayerPositionAndLook, 0x12 },
+    { outbound::PlayerLook, 0x13 },
+    { outbound::Player, 0x14 },
+    { outbound::VehicleMove, 0x15 },
+    { outbound::SteerBoat, 0x16 },
+    // PickItem = 0x17
+    { outbound::CraftRecipeRequest, 0x18 },
+    { outbound::PlayerAbilities, 0x19 },
+    { outbound::PlayerDigging, 0x1A },
+    { outbound::EntityAction, 0x1B },
+    { outbound::SteerVehicle, 0x1C },
+    { outbound::CraftingBookData, 0x1D },
+    // NameItem = 0x1E
+    { outbound::ResourcePackStatus, 0x1F },
+    { outbound::AdvancementTab, 0x20 },
+    // SelectTrade = 0x21
+    // SetBeaconEffect = 0x22
+    { outbound::HeldItemChange, 0x23 },
+    // UpdateCommandBlock = 0x24
+    // UpdateCommandBlockMinecart = 0x25
+    { outbound::CreativeInventoryAction, 0x26 },
+    // UpdateJigsawBlock = 0x27
+    // UpdateStructure = 0x28
+    { outbound::UpdateSign, 0x29 },
+    { outbound::Animation, 0x2A },
+    { outbound::Spectate, 0x2B },
+    { outbound::PlayerBlockPlacement, 0x2C },
+    { outbound::UseItem, 0x2D },
+});
+
+constexpr OutboundTable outbound_1_16_5 = MakeOutboundTable({
+    // Handshake
+    { outbound::Handshake, 0x00 },
+
+    // Login
+    { outbound::LoginStart, 0x00 },
+    { outbound::EncryptionResponse, 0x01 },
+    { outbound::LoginPluginResponse, 0x02 },
+
+    // Status
+    { outbound::StatusRequest, 0x00 },
+    { outbound::StatusPing, 0x01 },
+
+    // Play
+    { outbound::TeleportConfirm, 0x00 },
+    // QueryBlockNBT = 0x01
+    // SetDifficulty = 0x02
+    { outbound::Chat, 0x03 },
+    { outbound::ClientStatus, 0x04 },
+    { outbound::ClientSettings, 0x05 },
+    { outbound::TabComplete, 0x06 },
+    { outbound::ConfirmTransaction, 0x07 },
+    { outbound::EnchantItem, 0x08 }, // = ClickWindowButton now
+    { outbound::ClickWindow, 0x09 },
+    { outbound::CloseWindow, 0x0A },
+    { outbound::PluginMessage, 0x0B },
+    // EditBook = 0x0C
+    // QueryEntityNBT = 0x0D
+    // Generate Structure = 0x0F
+    { outbound::UseEntity, 0x0E },
+    { outbound::KeepAlive, 0x10 },
+    // LockDifficulty = 0x11
+    { outbound::PlayerPosition, 0x12 },
+    { outbound::PlayerPositionAndLook, 0x13 },
+    { outbound::PlayerLook, 0x14 },
+    { outbound::Player, 0x15 },
+    { outbound::VehicleMove, 0x16 },
+    { outbound::SteerBoat, 0x17 },
+    // PickItem = 0x18
+    { outbound::CraftRecipeRequest, 0x19 },
+    { outbound::PlayerAbilities, 0x1A },
+    { outbound::PlayerDigging, 0x1B },
+    { outbound::EntityAction, 0x1C },
+    { outbound::SteerVehicle, 0x1D },
+    // DisplayedRecipe = 0x1E
+    // RecipeBookState = 0x1F
+    // NameItem = 0x20
+    { outbound::ResourcePackStatus, 0x21 },
+    { outbound::AdvancementTab, 0x22 },
+    // SelectTrade = 0x23
+    // SetBeaconEffect = 0x24
+    { outbound::HeldItemChange, 0x25 },
+    // UpdateCommandBlock = 0x26
+    // UpdateCommandBlockMinecart = 0x27
+    { outbound::CreativeInventoryAction, 0x28 },
+    // UpdateJigsawBlock = 0x29
+    // UpdateStructure = 0x2A
+    { outbound::UpdateSign, 0x2B },
+    { outbound::Animation, 0x2C },
+    { outbound::Spectate, 0x2D },
+    { outbound::PlayerBlockPlacement, 0x2E },
+    { outbound::UseItem, 0x2F },
+});
 
 // Protocol agnostic protocol id to packet creators.
 std::unordered_map<State, std::unordered_map<s32, PacketCreator>> agnosticStateMap = {
@@ -501,6 +517,7 @@ std::unordered_map<State, std::unordered_map<s32, PacketCreator>> agnosticStateM
             { protocol::play::AdvancementProgress,          []() -> packets::InboundPacket* { return new packets::in::AdvancementProgressPacket(); } },
             { protocol::play::Advancements,                 []() -> packets::InboundPacket* { return new packets::in::AdvancementsPacket(); } },
             { protocol::play::UnlockRecipes,                []() -> packets::InboundPacket* { return new packets::in::UnlockRecipesPacket(); } },
+            { protocol::play::UpdateLight,                  []() -> packets::InboundPacket* { return new packets::in::UpdateLightPacket(); } },
         }
     }
 };
@@ -983,7 +1000,7 @@ Protocol::StateMap inboundMap_1_14_2 = {
             { 0x21, protocol::play::ChunkData },
             { 0x22, protocol::play::Effect },
             { 0x23, protocol::play::Particle },
-            //{ 0x24, protocol::play::UpdateLight },
+            { 0x24, protocol::play::UpdateLight },
             { 0x25, protocol::play::JoinGame },
             { 0x26, protocol::play::Map },
             { 0x27, protocol::play::TradeList },
@@ -1100,7 +1117,7 @@ Protocol::StateMap inboundMap_1_15_2 = {
             { 0x22, protocol::play::ChunkData },
             { 0x23, protocol::play::Effect },
             { 0x24, protocol::play::Particle },
-            //{ 0x25, protocol::play::UpdateLight },
+            { 0x25, protocol::play::UpdateLight },
             { 0x26, protocol::play::JoinGame },
             { 0x27, protocol::play::Map },
             { 0x28, protocol::play::TradeList },
@@ -1215,7 +1232,7 @@ Protocol::StateMap inboundMap_1_16_5 = {
             { 0x20, protocol::play::ChunkData },
             { 0x21, protocol::play::Effect },
             { 0x22, protocol::play::Particle },
-            //{ 0x23, protocol::play::UpdateLight },
+            { 0x23, protocol::play::UpdateLight },
             { 0x24, protocol::play::JoinGame },
             { 0x25, protocol::play::Map },
             { 0x26, protocol::play::TradeList },
@@ -1277,50 +1294,59 @@ Protocol::StateMap inboundMap_1_16_5 = {
 };
 
 const std::unordered_map<Version, std::shared_ptr<Protocol>> protocolMap = {
-    { Version::Minecraft_Ping, std::make_shared<Protocol>(Version::Minecraft_1_10_2, inboundMap_1_11_2) },
-
-    { Version::Minecraft_1_10_2, std::make_shared<Protocol>(Version::Minecraft_1_10_2, inboundMap_1_11_2) },
-    { Version::Minecraft_1_11_0, std::make_shared<Protocol>(Version::Minecraft_1_11_0, inboundMap_1_11_2) },
-    { Version::Minecraft_1_11_2, std::make_shared<Protocol>(Version::Minecraft_1_11_2, inboundMap_1_11_2) },
-    { Version::Minecraft_1_12_0, std::make_shared<Protocol_1_12_0>(Version::Minecraft_1_12_0, inboundMap_1_12_0) },
-    { Version::Minecraft_1_12_1, std::make_shared<Protocol_1_12_1>(Version::Minecraft_1_12_1, inboundMap_1_12_1) },
-    { Version::Minecraft_1_12_2, std::make_shared<Protocol_1_12_1>(Version::Minecraft_1_12_2, inboundMap_1_12_1) },
-    { Version::Minecraft_1_13_2, std::make_shared<Protocol_1_13_2>(Version::Minecraft_1_13_2, inboundMap_1_13_2) },
-    { Version::Minecraft_1_14_2, std::make_shared<Protocol_1_14_2>(Version::Minecraft_1_14_2, inboundMap_1_14_2) },
-    { Version::Minecraft_1_15_2, std::make_shared<Protocol_1_15_2>(Version::Minecraft_1_15_2, inboundMap_1_15_2) },
-	{ Version::Minecraft_1_16_4, std::make_shared<Protocol_1_16_5>(Version::Minecraft_1_16_4, inboundMap_1_16_5) },
-	{ Version::Minecraft_1_16_5, std::make_shared<Protocol_1_16_5>(Version::Minecraft_1_16_5, inboundMap_1_16_5) },
+    { Version::Minecraft_Ping, std::make_shared<Protocol>(Version::Minecraft_1_10_2, inboundMap_1_11_2, outbound_1_11_2) },
+
+    { Version::Minecraft_1_10_2, std::make_shared<Protocol>(Version::Minecraft_1_10_2, inboundMap_1_11_2, outbound_1_11_2) },
+    { Version::Minecraft_1_11_0, std::make_shared<Protocol>(Version::Minecraft_1_11_0, inboundMap_1_11_2, outbound_1_11_2) },
+    { Version::Minecraft_1_11_2, std::make_shared<Protocol>(Version::Minecraft_1_11_2, inboundMap_1_11_2, outbound_1_11_2) },
+    { Version::Minecraft_1_12_0, std::make_shared<Protocol>(Version::Minecraft_1_12_0, inboundMap_1_12_0, outbound_1_12_0) },
+    { Version::Minecraft_1_12_1, std::make_shared<Protocol>(Version::Minecraft_1_12_1, inboundMap_1_12_1, outbound_1_12_1) },
+    { Version::Minecraft_1_12_2, std::make_shared<Protocol>(Version::Minecraft_1_12_2, inboundMap_1_12_1, outbound_1_12_1) },
+    { Version::Minecraft_1_13_2, std::make_shared<Protocol>(Version::Minecraft_1_13_2, inboundMap_1_13_2, outbound_1_13_2) },
+    { Version::Minecraft_1_14_2, std::make_shared<Protocol>(Version::Minecraft_1_14_2, inboundMap_1_14_2, outbound_1_14_2) },
+    { Version::Minecraft_1_15_2, std::make_shared<Protocol>(Version::Minecraft_1_15_2, inboundMap_1_15_2, outbound_1_15_2) },
+	{ Version::Minecraft_1_16_4, std::make_shared<Protocol>(Version::Minecraft_1_16_4, inboundMap_1_16_5, outbound_1_16_5) },
+	{ Version::Minecraft_1_16_5, std::make_shared<Protocol>(Version::Minecraft_1_16_5, inboundMap_1_16_5, outbound_1_16_5) },
 };
 
-bool Protocol::GetAgnosticId(State state, s32 protocolId, s32& agnosticId) {
-    auto& packetMap = m_InboundMap[state];
-    auto iter = packetMap.find(protocolId);
+Protocol::Protocol(Version version, const StateMap& inbound, const OutboundTable& outbound)
+    : m_OutboundTable(&outbound),
+      m_Version(version)
+{
+    for (const auto& stateKv : inbound) {
+        auto& creators = agnosticStateMap[stateKv.first];
+        auto& types = m_InboundTypes[(std::size_t)stateKv.first];
+
+        for (const auto& kv : stateKv.second) {
+            std::size_t protocolId = (std::size_t)kv.first;
 
-    if (iter == packetMap.end()) 
-        return false;
+            if (protocolId >= types.size())
+                types.resize(protocolId + 1, InboundType{ nullptr, -1 });
 
-    agnosticId = iter->second;
+            auto iter = creators.find(kv.second);
+            PacketCreator creator = iter != creators.end() ? iter->second : nullptr;
 
-    return true;
+            types[protocolId] = InboundType{ creator, kv.second };
+        }
+    }
+}
+
+void Protocol::ThrowUnsupported(const char* name) const {
+    throw UnsupportedPacketException(std::string(name) + " is not supported by protocol " + to_string(m_Version));
 }
 
 packets::InboundPacket* Protocol::CreateInboundPacket(State state, s32 protocolId) {
-    s32 agnosticId = 0;
+    const InboundType* type = GetInboundType(state, protocolId);
 
-    if (!GetAgnosticId(state, protocolId, agnosticId))
+    if (type == nullptr || type->creator == nullptr)
         return nullptr;
-    
-    packets::InboundPacket* packet = nullptr;
 
-    auto stateMap = agnosticStateMap[state];
-    auto iter = stateMap.find(agnosticId);
-    if (iter != stateMap.end()) {
-        packet = iter->second();
+    packets::InboundPacket* packet = type->creator();
 
-        if (packet) {
-            packet->SetId(protocolId);
-            packet->SetProtocolVersion(m_Version);
-        }
+    if (packet) {
+        packet->SetId(protocolId);
+        packet->SetAgnosticId(type->agnosticId);
+        packet->SetProtocolVersion(m_Version);
     }
 
     return packet;
@@ -46,6 +46,26 @@ namespace mc{
 				return m_Connection;
 			}
 
+			bool InboundPacket::Deserialize(DataBufferView& data, std::size_t packetLength){
+				// Copy the whole payload so packets see the same buffer layout as before.
+				DataBuffer buffer;
+				std::size_t readOffset = data.GetReadOffset();
+
+				data.SetReadOffset(0);
+				data.ReadSome(buffer, data.GetSize());
+				buffer.SetReadOffset(readOffset);
+
+				return Deserialize(buffer, packetLength);
+			}
+
+			bool InboundPacket::DeserializeFromView(DataBuffer& data, std::size_t packetLength){
+				DataBufferView view(data);
+				bool result = Deserialize(view, packetLength);
+
+				data.SetReadOffset(view.GetReadOffset());
+				return result;
+			}
+
 			namespace in{
 
 				// Play packets
@@ -1036,6 +1056,10 @@ namespace mc{
 				}
 
 				bool KeepAlivePacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool KeepAlivePacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					if (this->GetProtocolVersion() < Version::Minecraft_1_12_2){
 						VarInt aliveId;
 
@@ -1069,10 +1093,11 @@ namespace mc{
 
 					metadata.sectionmask = mask.GetInt();
 
-                    if(GetProtocolVersion() >= Version::Minecraft_1_14_2){
-					    nbt::NBT heightmaps;
-					    data >> heightmaps;
-                    }
+					nbt::NBT heightmaps;
+
+					if (GetProtocolVersion() >= Version::Minecraft_1_14_2){
+						data >> heightmaps;
+					}
 
 					if (GetProtocolVersion() > Version::Minecraft_1_15_2){
 
@@ -1106,6 +1131,19 @@ namespace mc{
 
 					data >> *m_ChunkColumn;
 
+					// Up to 1.15.2 the heightmap entries span across longs.
+					const bool aligned = GetProtocolVersion() > Version::Minecraft_1_15_2;
+					auto motionBlocking = heightmaps.GetTag<nbt::TagLongArray>(L"MOTION_BLOCKING");
+					auto worldSurface = heightmaps.GetTag<nbt::TagLongArray>(L"WORLD_SURFACE");
+
+					// Older versions don't send the heightmaps and some newer ones only send MOTION_BLOCKING.
+					if (!motionBlocking || !worldSurface ||
+						!m_ChunkColumn->GetHeightmap(world::Heightmap::Type::MotionBlocking).Load(motionBlocking->GetValue(), aligned) ||
+						!m_ChunkColumn->GetHeightmap(world::Heightmap::Type::WorldSurface).Load(worldSurface->GetValue(), aligned))
+					{
+						m_ChunkColumn->UpdateHeightmaps();
+					}
+
 					// Skip biome information
 					if (GetProtocolVersion() <= Version::Minecraft_1_13_2 && metadata.continuous){
 						data.SetReadOffset(data.GetReadOffset() + 256);
@@ -1376,6 +1414,10 @@ namespace mc{
 				}
 
 				bool EntityRelativeMovePacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool EntityRelativeMovePacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					VarInt eid;
 
 					data >> eid;
@@ -1396,6 +1438,10 @@ namespace mc{
 				}
 
 				bool EntityLookAndRelativeMovePacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool EntityLookAndRelativeMovePacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					VarInt eid;
 
 					data >> eid >> m_Delta.x >> m_Delta.y >> m_Delta.z;
@@ -1416,6 +1462,10 @@ namespace mc{
 				}
 
 				bool EntityLookPacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool EntityLookPacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					VarInt eid;
 
 					data >> eid;
@@ -1889,6 +1939,10 @@ namespace mc{
 				}
 
 				bool EntityHeadLookPacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool EntityHeadLookPacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					VarInt eid;
 					data >> eid;
 					data >> m_Yaw;
@@ -2063,6 +2117,10 @@ namespace mc{
 				}
 
 				bool EntityVelocityPacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool EntityVelocityPacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					VarInt eid;
 					data >> eid;
 					data >> m_Velocity.x;
@@ -2322,6 +2380,10 @@ namespace mc{
 				}
 
 				bool TimeUpdatePacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool TimeUpdatePacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					data >> m_WorldAge;
 					data >> m_Time;
 					return true;
@@ -2441,6 +2503,10 @@ namespace mc{
 				}
 
 				bool EntityTeleportPacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					return DeserializeFromView(data, packetLength);
+				}
+
+				bool EntityTeleportPacket::Deserialize(DataBufferView& data, std::size_t packetLength){
 					VarInt eid;
 
 					data >> eid;
@@ -2564,6 +2630,67 @@ namespace mc{
 					handler->HandlePacket(this);
 				}
 
+				UpdateLightPacket::UpdateLightPacket()
+					: m_ChunkX(0), m_ChunkZ(0), m_TrustEdges(false){
+
+				}
+
+				bool UpdateLightPacket::Deserialize(DataBuffer& data, std::size_t packetLength){
+					VarInt chunkX, chunkZ;
+					VarInt skyMask, blockMask, emptySkyMask, emptyBlockMask;
+
+					data >> chunkX >> chunkZ;
+
+					if (GetProtocolVersion() > Version::Minecraft_1_15_2){
+						data >> m_TrustEdges;
+					}
+
+					data >> skyMask >> blockMask >> emptySkyMask >> emptyBlockMask;
+
+					m_ChunkX = chunkX.GetInt();
+					m_ChunkZ = chunkZ.GetInt();
+
+					auto readSections = [&data](s32 mask, s32 emptyMask, SectionLight& sections){
+						sections.clear();
+
+						for (s32 i = 0; i < world::ColumnLight::SectionCount; ++i){
+							if (mask & (1 << i)){
+								VarInt length;
+								data >> length;
+
+								if (length.GetInt() != world::NibbleArray::Size || data.GetRemaining() < world::NibbleArray::Size){
+									return false;
+								}
+
+								sections.emplace_back(i - 1, world::NibbleArray(&data[data.GetReadOffset()]));
+								data.SetReadOffset(data.GetReadOffset() + world::NibbleArray::Size);
+							}else if (emptyMask & (1 << i)){
+								sections.emplace_back(i - 1, world::NibbleArray());
+							}
+						}
+
+						return true;
+					};
+
+					// The sky light arrays are all sent before the block light arrays.
+					return readSections(skyMask.GetInt(), emptySkyMask.GetInt(), m_SkyLight) &&
+						readSections(blockMask.GetInt(), emptyBlockMask.GetInt(), m_BlockLight);
+				}
+
+				void UpdateLightPacket::Dispatch(PacketHandler* handler){
+					handler->HandlePacket(this);
+				}
+
+				void UpdateLightPacket::Apply(world::ColumnLight& light) const{
+					for (const auto& section : m_SkyLight){
+						light.SetSkyLight(section.first, section.second);
+					}
+
+					for (const auto& section : m_BlockLight){
+						light.SetBlockLight(section.first, section.second);
+					}
+				}
+
 
 				// Login packets
 				DisconnectPacket::DisconnectPacket(){
@@ -3,16 +3,19 @@
 #include <mclib/protocol/packets/PacketHandler.h>
 
 #include <algorithm>
-#include <unordered_map>
 
 namespace mc {
 namespace protocol {
 namespace packets {
 
 s32 GetDispatcherId(Packet* packet) {
+    // Inbound packets created by the protocol already know their id.
+    if (packet->GetAgnosticId() >= 0)
+        return packet->GetAgnosticId();
+
     auto version = packet->GetProtocolVersion();
 
-    protocol::Protocol protocol = protocol::Protocol::GetProtocol(version);
+    protocol::Protocol& protocol = protocol::Protocol::GetProtocol(version);
 
     s32 agnosticId = 0;
     if (!protocol.GetAgnosticId(packet->GetProtocolState(), packet->GetId().GetInt(), agnosticId)) {
@@ -22,41 +25,110 @@ s32 GetDispatcherId(Packet* packet) {
     return agnosticId;
 }
 
+PacketDispatcher::PacketType* PacketDispatcher::GetType(protocol::State protocolState, PacketId id) {
+    auto& types = m_Types[(std::size_t)protocolState];
+
+    if (id < 0 || (std::size_t)id >= types.size()) return nullptr;
+
+    return &types[(std::size_t)id];
+}
+
+const PacketDispatcher::PacketType* PacketDispatcher::GetType(protocol::State protocolState, PacketId id) const {
+    auto& types = m_Types[(std::size_t)protocolState];
+
+    if (id < 0 || (std::size_t)id >= types.size()) return nullptr;
+
+    return &types[(std::size_t)id];
+}
+
+PacketDispatcher::PacketType& PacketDispatcher::GetOrCreateType(protocol::State protocolState, PacketId id) {
+    if (id < 0)
+        throw std::out_of_range("Packet id can't be negative.");
+
+    auto& types = m_Types[(std::size_t)protocolState];
+
+    if ((std::size_t)id >= types.size())
+        types.resize((std::size_t)id + 1);
+
+    return types[(std::size_t)id];
+}
+
+void PacketDispatcher::Compact(protocol::State protocolState) {
+    auto& types = m_Types[(std::size_t)protocolState];
+
+    // Drop unused types at the end so the table only covers registered ids.
+    while (!types.empty() && types.back().handlers.empty() && !types.back().alwaysDecode)
+        types.pop_back();
+}
+
 void PacketDispatcher::RegisterHandler(protocol::State protocolState, PacketId id, PacketHandler* handler) {
-    PacketType type(protocolState, id);
-    std::vector<PacketHandler*>::iterator found = std::find(m_Handlers[type].begin(), m_Handlers[type].end(), handler);
-    if (found == m_Handlers[type].end())
-        m_Handlers[type].push_back(handler);
+    auto& handlers = GetOrCreateType(protocolState, id).handlers;
+
+    if (std::find(handlers.begin(), handlers.end(), handler) == handlers.end())
+        handlers.push_back(handler);
 }
 
 void PacketDispatcher::UnregisterHandler(protocol::State protocolState, PacketId id, PacketHandler* handler) {
-    PacketType type(protocolState, id);
-    std::vector<PacketHandler*>::iterator found = std::find(m_Handlers[type].begin(), m_Handlers[type].end(), handler);
-    if (found != m_Handlers[type].end())
-        m_Handlers[type].erase(found);
+    PacketType* type = GetType(protocolState, id);
+    if (type == nullptr) return;
+
+    auto found = std::find(type->handlers.begin(), type->handlers.end(), handler);
+    if (found != type->handlers.end())
+        type->handlers.erase(found);
+
+    Compact(protocolState);
 }
 
 void PacketDispatcher::UnregisterHandler(PacketHandler* handler) {
-    for (auto& pair : m_Handlers) {
-        if (pair.second.empty()) continue;
+    for (std::size_t state = 0; state < StateCount; ++state) {
+        for (auto& type : m_Types[state])
+            type.handlers.erase(std::remove(type.handlers.begin(), type.handlers.end(), handler), type.handlers.end());
+
+        Compact((protocol::State)state);
+    }
+}
+
+bool PacketDispatcher::HasHandlers(protocol::State protocolState, PacketId id) const {
+    const PacketType* type = GetType(protocolState, id);
+
+    return type != nullptr && !type->handlers.empty();
+}
 
-        auto state = pair.first.first;
-        auto id = pair.first.second;
-        PacketType type(state, id);
+void PacketDispatcher::SetAlwaysDecode(protocol::State protocolState, PacketId id, bool decode) {
+    if (decode) {
+        GetOrCreateType(protocolState, id).alwaysDecode = true;
+    } else {
+        PacketType* type = GetType(protocolState, id);
+        if (type == nullptr) return;
 
-        m_Handlers[type].erase(std::remove(m_Handlers[type].begin(), m_Handlers[type].end(), handler), m_Handlers[type].end());
+        type->alwaysDecode = false;
+        Compact(protocolState);
     }
 }
 
+bool PacketDispatcher::ShouldDecode(protocol::State protocolState, PacketId id) const {
+    const PacketType* type = GetType(protocolState, id);
+
+    return type != nullptr && (type->alwaysDecode || !type->handlers.empty());
+}
+
+std::size_t PacketDispatcher::GetTableSize(protocol::State protocolState) const {
+    return m_Types[(std::size_t)protocolState].size();
+}
+
 void PacketDispatcher::Dispatch(Packet* packet) {
     if (!packet) return;
 
     auto state = packet->GetProtocolState();
     s64 id = GetDispatcherId(packet);
-    
-    PacketType type(state, id);
-    for (PacketHandler* handler : m_Handlers[type])
-        packet->Dispatch(handler);
+
+    // Look the type up for each handler since handlers can register or unregister others while being dispatched to.
+    for (std::size_t i = 0; ; ++i) {
+        PacketType* type = GetType(state, id);
+        if (type == nullptr || i >= type->handlers.size()) break;
+
+        packet->Dispatch(type->handlers[i]);
+    }
 }
 
 } // ns packets
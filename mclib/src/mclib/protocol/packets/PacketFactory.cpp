@@ -1,41 +1,166 @@
 #include <mclib/protocol/packets/PacketFactory.h>
 
 #include <mclib/core/Connection.h>
+#include <mclib/protocol/packets/PacketDispatcher.h>
 
 #include <exception>
 #include <string>
 #include <iostream>
+#include <vector>
+
+namespace {
+
+using mc::protocol::packets::InboundPacket;
+
+// Keeps freed packets around so the steady packet flow doesn't allocate.
+// There's one pool per thread, so connections running on different threads never share packets.
+class PacketPool {
+private:
+    // How many free packets are kept per packet type
+    static const std::size_t MaxFreePerType = 32;
+    static const std::size_t StateCount = 4;
+
+    // Free packets indexed by protocol state and then by agnostic id
+    std::vector<std::vector<InboundPacket*>> m_Free[StateCount];
+
+public:
+    PacketPool() = default;
+    PacketPool(const PacketPool& other) = delete;
+    PacketPool& operator=(const PacketPool& other) = delete;
+
+    ~PacketPool() {
+        for (auto& state : m_Free) {
+            for (auto& packets : state) {
+                for (InboundPacket* packet : packets)
+                    delete packet;
+            }
+        }
+    }
+
+    InboundPacket* Acquire(mc::protocol::State state, s32 agnosticId) {
+        auto& types = m_Free[(std::size_t)state];
+
+        if (agnosticId < 0 || (std::size_t)agnosticId >= types.size()) return nullptr;
+
+        auto& packets = types[agnosticId];
+        if (packets.empty()) return nullptr;
+
+        InboundPacket* packet = packets.back();
+        packets.pop_back();
+        return packet;
+    }
+
+    std::size_t GetFreeCount(mc::protocol::State state, s32 agnosticId) const {
+        const auto& types = m_Free[(std::size_t)state];
+
+        if (agnosticId < 0 || (std::size_t)agnosticId >= types.size()) return 0;
+
+        return types[agnosticId].size();
+    }
+
+    // Returns false if the pool didn't take the packet.
+    bool Release(InboundPacket* packet) {
+        s32 agnosticId = packet->GetAgnosticId();
+
+        if (agnosticId < 0) return false;
+
+        auto& types = m_Free[(std::size_t)packet->GetProtocolState()];
+
+        if ((std::size_t)agnosticId >= types.size())
+            types.resize(agnosticId + 1);
+
+        auto& packets = types[agnosticId];
+
+        if (packets.size() >= MaxFreePerType || !packet->Reset())
+            return false;
+
+        packets.push_back(packet);
+        return true;
+    }
+};
+
+thread_local PacketPool s_PacketPool;
+
+} // ns
 
 namespace mc {
 namespace protocol {
 namespace packets {
 
-Packet* PacketFactory::CreatePacket(Protocol& protocol, protocol::State state, DataBuffer data, std::size_t length, core::Connection* connection) {
-    if (data.GetSize() == 0) return nullptr;
+DecodeResult PacketFactory::TryCreatePacket(Protocol& protocol, protocol::State state, DataBufferView data, std::size_t length, core::Connection* connection, Packet*& result) {
+    result = nullptr;
 
     VarInt vid;
-    data >> vid;
+    // The frame was fully received, so an unfinished id can never complete.
+    if (TryReadVarInt(data, vid) != DecodeResult::Success)
+        return DecodeResult::Malformed;
+
+    s32 agnosticId = 0;
+
+    if (!protocol.GetAgnosticId(state, vid.GetInt(), agnosticId))
+        return DecodeResult::UnknownPacket;
 
-    InboundPacket* packet = protocol.CreateInboundPacket(state, vid.GetInt());
+    // Nothing would see the packet, so skip deserializing it.
+    if (connection && !connection->GetDispatcher()->ShouldDecode(state, agnosticId))
+        return DecodeResult::Skipped;
+
+    InboundPacket* packet = s_PacketPool.Acquire(state, agnosticId);
 
     if (packet) {
-        packet->SetConnection(connection);
-        try {
-          packet->Deserialize(data, length);
-        } catch (std::exception & e) {
-          std::cerr << vid.GetInt() << ": " << e.what();
-        }
+        packet->SetId(vid.GetInt());
+        packet->SetProtocolVersion(protocol.GetVersion());
     } else {
-        throw protocol::UnfinishedProtocolException(vid, state);
+        packet = protocol.CreateInboundPacket(state, vid.GetInt());
+
+        // Known to the protocol, but mclib can't create it yet.
+        if (!packet)
+            return DecodeResult::UnknownPacket;
+    }
+
+    packet->SetConnection(connection);
+    try {
+      packet->Deserialize(data, length);
+    } catch (std::exception & e) {
+      std::cerr << vid.GetInt() << ": " << e.what();
+    }
+
+    result = packet;
+    return DecodeResult::Success;
+}
+
+Packet* PacketFactory::CreatePacket(Protocol& protocol, protocol::State state, DataBufferView data, std::size_t length, core::Connection* connection) {
+    if (data.GetSize() == 0) return nullptr;
+
+    Packet* packet = nullptr;
+
+    switch (TryCreatePacket(protocol, state, data, length, connection, packet)) {
+        case DecodeResult::UnknownPacket:
+        case DecodeResult::Malformed:
+        {
+            VarInt vid;
+            TryReadVarInt(data, vid);
+            throw protocol::UnfinishedProtocolException(vid, state);
+        }
+        default:
+            break;
     }
 
     return packet;
 }
 
 void PacketFactory::FreePacket(Packet* packet) {
+    InboundPacket* inbound = dynamic_cast<InboundPacket*>(packet);
+
+    if (inbound && s_PacketPool.Release(inbound))
+        return;
+
     delete packet;
 }
 
+std::size_t PacketFactory::GetFreeCount(State state, s32 agnosticId) {
+    return s_PacketPool.GetFreeCount(state, agnosticId);
+}
+
 } // ns packets
 } // ns protocol
 } // ns mc
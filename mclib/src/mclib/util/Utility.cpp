@@ -7,6 +7,7 @@
 #include <mclib/core/PlayerManager.h>
 #include <mclib/entity/EntityManager.h>
 #include <mclib/protocol/Protocol.h>
+#include <mclib/world/BlockAccessor.h>
 #include <mclib/world/World.h>
 
 #include <iostream>
@@ -330,19 +331,17 @@ bool PlayerController::ClearPath(Vector3d target) {
 
     const double CheckWidth = 0.3;
 
+    world::BlockAccessor blocks(m_World);
+
     auto check = [&](Vector3d start, Vector3d delta) {
-        Vector3d checkAbove = start + delta + Vector3d(0, 1, 0);
-        Vector3d checkBelow = start + delta + Vector3d(0, 0, 0);
-        block::BlockPtr aboveBlock = m_World.GetBlock(checkAbove);
-        block::BlockPtr belowBlock = m_World.GetBlock(checkBelow);
+        Vector3i checkBelow = ToVector3i(start + delta);
 
-        if (aboveBlock && aboveBlock->IsSolid())
+        if (blocks.IsSolid(checkBelow.x, checkBelow.y + 1, checkBelow.z))
             return false;
 
-        if (belowBlock && belowBlock->IsSolid()) {
-            block::BlockPtr twoAboveBlock = m_World.GetBlock(checkAbove + Vector3d(0, 1, 0));
+        if (blocks.IsSolid(checkBelow)) {
             // Bad path if there isn't a two high gap in it
-            if (twoAboveBlock && twoAboveBlock->IsSolid())
+            if (blocks.IsSolid(checkBelow.x, checkBelow.y + 2, checkBelow.z))
                 return false;
 
             // Jump up 1 block to keep searching
@@ -358,13 +357,10 @@ bool PlayerController::ClearPath(Vector3d target) {
         if (!check(position + side * CheckWidth, delta)) return false;
         if (!check(position - side * CheckWidth, delta)) return false;
 
-        Vector3d checkFloor = position + delta + Vector3d(0, -1, 0);
-        block::BlockPtr floorBlock = m_World.GetBlock(checkFloor);
-        if (floorBlock && !floorBlock->IsSolid()) {
-            block::BlockPtr belowFloorBlock = m_World.GetBlock(checkFloor - Vector3d(0, 1, 0));
-
+        Vector3i checkFloor = ToVector3i(position + delta + Vector3d(0, -1, 0));
+        if (!blocks.IsSolid(checkFloor)) {
             // Fail if there is a two block drop
-            if (belowFloorBlock && !belowFloorBlock->IsSolid())
+            if (!blocks.IsSolid(checkFloor.x, checkFloor.y - 1, checkFloor.z))
                 return false;
 
             position.y--;
@@ -425,15 +421,18 @@ std::vector<std::pair<block::BlockPtr, Vector3i>> PlayerController::GetNearbyBlo
 
     std::vector<BlockPos> nearbyBlocks;
 
+    block::BlockRegistry* registry = block::BlockRegistry::GetInstance();
+    world::BlockAccessor blocks(m_World);
+
     for (s32 x = -radius; x < radius; ++x) {
         for (s32 y = -radius; y < radius; ++y) {
             for (s32 z = -radius; z < radius; ++z) {
-                Vector3d checkPos = m_Position + Vector3d(x, y, z);
+                Vector3i checkPos = mc::ToVector3i(m_Position + Vector3d(x, y, z));
 
-                auto state = m_World.GetBlock(checkPos);
+                u32 stateId = blocks.GetStateId(checkPos);
 
-                if (state && state->IsSolid())
-                    nearbyBlocks.push_back(std::make_pair<>(state, mc::ToVector3i(checkPos)));
+                if (registry->IsSolid(stateId))
+                    nearbyBlocks.push_back(std::make_pair<>(registry->GetBlock(stateId), checkPos));
             }
         }
     }
@@ -555,11 +554,11 @@ void PlayerController::Update() {
             const float FullCircle = 2.0f * 3.14159f;
             const float CheckWidth = 0.3f;
             onGround = false;
+            world::BlockAccessor blocks(m_World);
             for (float angle = 0.0f; angle < FullCircle; angle += FullCircle / 8) {
                 Vector3d checkPos = m_Position + Vector3RotateAboutY(Vector3d(0, 0, CheckWidth), angle) - Vector3d(0, 1, 0);
 
-                block::BlockPtr checkBlock = m_World.GetBlock(checkPos);
-                if (checkBlock && checkBlock->IsSolid()) {
+                if (blocks.IsSolid(ToVector3i(checkPos))) {
                     onGround = true;
                     break;
                 }
@@ -0,0 +1,49 @@
+#include <mclib/world/BlockAccessor.h>
+
+#include <limits>
+
+namespace {
+
+// No position shifts down to this, so it forces the first lookup.
+const s64 Unresolved = std::numeric_limits<s64>::min();
+
+} // ns
+
+namespace mc {
+namespace world {
+
+BlockAccessor::BlockAccessor(const World& world)
+    : BlockAccessor(world, Vector3i())
+{
+}
+
+BlockAccessor::BlockAccessor(const World& world, Vector3i position)
+    : m_World(&world),
+      m_Registry(block::BlockRegistry::GetInstance()),
+      m_Position(position)
+{
+    Invalidate();
+}
+
+void BlockAccessor::Invalidate() {
+    m_SectionX = m_SectionY = m_SectionZ = Unresolved;
+    m_Column = nullptr;
+    m_Section = nullptr;
+}
+
+void BlockAccessor::Resolve(s64 x, s64 y, s64 z) {
+    if (x != m_SectionX || z != m_SectionZ)
+        m_Column = m_World->GetChunkColumn(Vector3i(x * 16, 0, z * 16));
+
+    m_SectionX = x;
+    m_SectionY = y;
+    m_SectionZ = z;
+
+    if (m_Column && y >= 0 && y < ChunkColumn::ChunksPerColumn)
+        m_Section = (*m_Column)[(std::size_t)y].get();
+    else
+        m_Section = nullptr;
+}
+
+} // ns world
+} // ns mc
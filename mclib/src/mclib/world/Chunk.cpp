@@ -1,113 +1,397 @@
 #include <mclib/world/Chunk.h>
 
 #include <mclib/common/DataBuffer.h>
+#include <mclib/common/VarInt.h>
 
 #include <algorithm>
+#include <stdexcept>
 
 namespace mc{
 	namespace world{
 
-		Chunk::Chunk(){
-			m_BitsPerBlock = 4;
+		namespace{
+
+			const std::size_t BlocksPerChunk = 16 * 16 * 16;
+			// The direct format uses up to 15 bits in 1.16, so anything larger can't be valid.
+			const u8 MaxBitsPerBlock = 16;
+
+			// Reads one section of light levels from the chunk data.
+			NibbleArray ReadLight(DataBuffer& in){
+				if (in.GetRemaining() < NibbleArray::Size)
+					throw std::runtime_error("Chunk section light data is larger than the packet.");
+
+				NibbleArray light(&in[in.GetReadOffset()]);
+				in.SetReadOffset(in.GetReadOffset() + NibbleArray::Size);
+				return light;
+			}
+
+			// Whether a block counts toward a heightmap.
+			bool IsHeightmapBlock(const block::BlockRegistry* registry, Heightmap::Type type, u32 stateId){
+				if (type == Heightmap::Type::WorldSurface){
+					return stateId != 0;
+				}
+
+				return registry->IsMotionBlocking(stateId);
+			}
+
+			// Returns the number of bits needed to store value.
+			u8 GetBitsFor(u32 value){
+				u8 bits = 1;
+
+				while ((value >> bits) != 0){
+					++bits;
+				}
+
+				return bits;
+			}
+
+			// Entry access for one bits per block and layout, so the shifts and masks are constants.
+			template <u8 Bits, bool Aligned>
+			struct PackedEntries{
+				static const u64 Mask = (1ULL << Bits) - 1;
+				static const std::size_t PerLong = 64 / Bits;
+				// Entries can only cross into the next long when Bits doesn't divide 64.
+				static const bool CanSpan = !Aligned && 64 % Bits != 0;
+
+				static u32 Get(const u64* data, std::size_t index){
+					if (Aligned){
+						return (u32)((data[index / PerLong] >> ((index % PerLong) * Bits)) & Mask);
+					}
+
+					const std::size_t bitIndex = index * Bits;
+					const std::size_t start = bitIndex / 64;
+					const std::size_t offset = bitIndex % 64;
+
+					u64 value = data[start] >> offset;
+
+					if (CanSpan && offset + Bits > 64){
+						value |= data[start + 1] << (64 - offset);
+					}
+
+					return (u32)(value & Mask);
+				}
+
+				// Unpacks count entries starting at begin, reading each long once instead of locating every entry.
+				static void Unpack(const u64* data, std::size_t begin, std::size_t count, u32* out){
+					if (Aligned){
+						const std::size_t end = begin + count;
+
+						for (std::size_t i = begin; i < end; ){
+							u64 word = data[i / PerLong] >> ((i % PerLong) * Bits);
+							const std::size_t run = std::min(PerLong - i % PerLong, end - i);
+
+							for (std::size_t n = 0; n < run; ++n){
+								*out++ = (u32)(word & Mask);
+								word >>= Bits;
+							}
+
+							i += run;
+						}
+						return;
+					}
+
+					const std::size_t bitIndex = begin * Bits;
+					const u64* word = data + bitIndex / 64;
+					std::size_t offset = bitIndex % 64;
+
+					for (std::size_t n = 0; n < count; ++n){
+						u64 value = *word >> offset;
+
+						offset += Bits;
+						if (offset >= 64){
+							// Only touch the next long if part of this entry is in it, it doesn't exist after the last entry.
+							++word;
+							offset -= 64;
+							if (CanSpan && offset > 0){
+								value |= *word << (Bits - offset);
+							}
+						}
+
+						*out++ = (u32)(value & Mask);
+					}
+				}
+
+				static void Set(u64* data, std::size_t index, u32 value){
+					const u64 entry = (u64)value & Mask;
+
+					if (Aligned){
+						const std::size_t shift = (index % PerLong) * Bits;
+						u64& packed = data[index / PerLong];
+
+						packed = (packed & ~(Mask << shift)) | (entry << shift);
+						return;
+					}
+
+					const std::size_t bitIndex = index * Bits;
+					const std::size_t start = bitIndex / 64;
+					const std::size_t offset = bitIndex % 64;
+
+					data[start] = (data[start] & ~(Mask << offset)) | (entry << offset);
+
+					if (CanSpan && offset + Bits > 64){
+						// The low bits went into the first long, the rest go into the bottom of the next one.
+						const std::size_t stored = 64 - offset;
+
+						data[start + 1] = (data[start + 1] & ~(Mask >> stored)) | (entry >> stored);
+					}
+				}
+			};
+
+		} // ns
+
+		struct Chunk::PackedAccess{
+			u32 (*get)(const u64* data, std::size_t index);
+			void (*set)(u64* data, std::size_t index, u32 value);
+			void (*unpack)(const u64* data, std::size_t begin, std::size_t count, u32* out);
+		};
+
+		Chunk::Chunk()
+			: m_SingleValue(0), m_BitsPerBlock(0), m_Layout(Layout::Spanning), m_Access(nullptr){
 		}
 
-		Chunk::Chunk(const Chunk& other){
-			m_Data = other.m_Data;
-			m_BitsPerBlock = other.m_BitsPerBlock;
+		Chunk::Chunk(const Chunk& other)
+			: m_Palette(other.m_Palette), m_PaletteIndex(other.m_PaletteIndex), m_PaletteCounts(other.m_PaletteCounts), m_Data(other.m_Data), m_SingleValue(other.m_SingleValue), m_BitsPerBlock(other.m_BitsPerBlock), m_Layout(other.m_Layout), m_Access(other.m_Access){
 		}
 
 		Chunk& Chunk::operator=(const Chunk& other){
+			m_Palette = other.m_Palette;
+			m_PaletteIndex = other.m_PaletteIndex;
+			m_PaletteCounts = other.m_PaletteCounts;
 			m_Data = other.m_Data;
+			m_SingleValue = other.m_SingleValue;
 			m_BitsPerBlock = other.m_BitsPerBlock;
+			m_Layout = other.m_Layout;
+			m_Access = other.m_Access;
 			return *this;
 		}
 
+		std::size_t Chunk::GetDataSize(u8 bitsPerBlock, Layout layout){
+			if (layout == Layout::Aligned){
+				const std::size_t perLong = 64 / bitsPerBlock;
+
+				return (BlocksPerChunk + perLong - 1) / perLong;
+			}
+
+			return BlocksPerChunk * bitsPerBlock / 64;
+		}
+
+		void Chunk::SetFormat(u8 bitsPerBlock, Layout layout){
+#define MCLIB_PACKED_ACCESS(bits) \
+			{ &PackedEntries<bits, false>::Get, &PackedEntries<bits, false>::Set, &PackedEntries<bits, false>::Unpack }, \
+			{ &PackedEntries<bits, true>::Get, &PackedEntries<bits, true>::Set, &PackedEntries<bits, true>::Unpack }
+
+			static const PackedAccess access[MaxBitsPerBlock * 2] = {
+				MCLIB_PACKED_ACCESS(1), MCLIB_PACKED_ACCESS(2), MCLIB_PACKED_ACCESS(3), MCLIB_PACKED_ACCESS(4),
+				MCLIB_PACKED_ACCESS(5), MCLIB_PACKED_ACCESS(6), MCLIB_PACKED_ACCESS(7), MCLIB_PACKED_ACCESS(8),
+				MCLIB_PACKED_ACCESS(9), MCLIB_PACKED_ACCESS(10), MCLIB_PACKED_ACCESS(11), MCLIB_PACKED_ACCESS(12),
+				MCLIB_PACKED_ACCESS(13), MCLIB_PACKED_ACCESS(14), MCLIB_PACKED_ACCESS(15), MCLIB_PACKED_ACCESS(16)
+			};
+
+#undef MCLIB_PACKED_ACCESS
+
+			if (bitsPerBlock == 0 || bitsPerBlock > MaxBitsPerBlock){
+				throw std::runtime_error("Chunk section has an invalid number of bits per block.");
+			}
+
+			m_BitsPerBlock = bitsPerBlock;
+			m_Layout = layout;
+			m_Access = &access[(bitsPerBlock - 1) * 2 + (layout == Layout::Aligned ? 1 : 0)];
+		}
+
+		void Chunk::SetSingleValue(u32 value){
+			m_SingleValue = value;
+			m_BitsPerBlock = 0;
+			m_Access = nullptr;
+			m_Palette.clear();
+			m_PaletteIndex.clear();
+			m_PaletteCounts.clear();
+			std::vector<u64>().swap(m_Data);
+		}
+
+		void Chunk::Promote(){
+			SetFormat(4, m_Layout);
+
+			// Every entry starts out as index 0, which is the old single value.
+			m_Palette.assign(1, m_SingleValue);
+			m_PaletteIndex.clear();
+			m_PaletteIndex[m_SingleValue] = 0;
+			m_PaletteCounts.assign(1, (u16)BlocksPerChunk);
+			m_Data.assign(GetDataSize(m_BitsPerBlock, m_Layout), 0);
+		}
+
+		void Chunk::Resize(u8 bitsPerBlock){
+			const PackedAccess* oldAccess = m_Access;
+			const bool wasDirect = m_BitsPerBlock >= 9;
+			std::vector<u64> oldData;
+
+			oldData.swap(m_Data);
+
+			SetFormat(bitsPerBlock, m_Layout);
+			m_Data.assign(GetDataSize(m_BitsPerBlock, m_Layout), 0);
+
+			const bool direct = m_BitsPerBlock >= 9;
+
+			for (std::size_t i = 0; i < BlocksPerChunk; ++i){
+				u32 value = oldAccess->get(oldData.data(), i);
+
+				if (direct && !wasDirect){
+					value = value < m_Palette.size() ? m_Palette[value] : 0;
+				}
+
+				m_Access->set(m_Data.data(), i, value);
+			}
+
+			if (direct){
+				m_Palette.clear();
+				m_PaletteIndex.clear();
+				m_PaletteCounts.clear();
+			}
+		}
+
+		u32 Chunk::GetOrAddPaletteIndex(u32 blockType){
+			if (m_BitsPerBlock >= 9){
+				if ((blockType >> m_BitsPerBlock) != 0){
+					Resize(GetBitsFor(blockType));
+				}
+
+				return blockType;
+			}
+
+			// Palettes read from the network only get their lookup once they're edited.
+			if (m_PaletteIndex.empty()){
+				for (std::size_t i = 0; i < m_Palette.size(); ++i){
+					m_PaletteIndex.emplace(m_Palette[i], (u32)i);
+				}
+			}
+
+			auto iter = m_PaletteIndex.find(blockType);
+			if (iter != m_PaletteIndex.end()) return iter->second;
+
+			const u32 paletteIndex = (u32)m_Palette.size();
+
+			if (paletteIndex >= (1u << m_BitsPerBlock)){
+				if (m_BitsPerBlock < 8){
+					Resize(m_BitsPerBlock + 1);
+				}else{
+					u32 maxValue = blockType;
+
+					for (u32 value : m_Palette){
+						maxValue = std::max(maxValue, value);
+					}
+
+					Resize(std::max<u8>(9, GetBitsFor(maxValue)));
+					return blockType;
+				}
+			}
+
+			m_Palette.push_back(blockType);
+			m_PaletteIndex.emplace(blockType, paletteIndex);
+			return paletteIndex;
+		}
+
+		void Chunk::CountPaletteEntries(){
+			u32 entries[256];
+
+			m_PaletteCounts.assign(m_Palette.size(), 0);
+
+			for (std::size_t begin = 0; begin < BlocksPerChunk; begin += 256){
+				m_Access->unpack(m_Data.data(), begin, 256, entries);
+
+				// Out of range entries read as air but don't belong to any palette entry.
+				for (u32 entry : entries){
+					if (entry < m_PaletteCounts.size()) ++m_PaletteCounts[entry];
+				}
+			}
+		}
+
+		bool Chunk::HasSingleEntry() const{
+			const u32 first = GetEntry(0);
+			u32 entries[256];
+
+			// Most sections differ within the first few rows, so they're rejected without decoding the rest.
+			for (std::size_t begin = 0; begin < BlocksPerChunk; begin += 256){
+				m_Access->unpack(m_Data.data(), begin, 256, entries);
+
+				for (u32 entry : entries){
+					if (entry != first) return false;
+				}
+			}
+
+			return true;
+		}
+
+		u32 Chunk::GetEntry(std::size_t index) const{
+			return m_Access->get(m_Data.data(), index);
+		}
+
+		void Chunk::SetEntry(std::size_t index, u32 value){
+			m_Access->set(m_Data.data(), index, value);
+		}
+
 		void Chunk::Load(DataBuffer& in, ChunkColumnMetadata* meta, s32 chunkIndex, protocol::Version version){
 			if (version >= protocol::Version::Minecraft_1_14_2){
+				// Number of blocks that aren't air. Cave and void air don't count, so it can't tell which air the section holds.
 				u16 blockCount;
 
 				in >> blockCount;
 			}
 
-			in >> m_BitsPerBlock;
+			u8 bitsPerBlock;
+			in >> bitsPerBlock;
 
-			if(m_BitsPerBlock < 4){
-				m_BitsPerBlock = 4;
+			if(bitsPerBlock < 4){
+				bitsPerBlock = 4;
 			}
 
+			// 1.16 stopped letting entries span across longs. The data is kept in whichever layout it arrives in.
+			SetFormat(bitsPerBlock, version > protocol::Version::Minecraft_1_15_2 ? Layout::Aligned : Layout::Spanning);
+
+			m_Palette.clear();
+			m_PaletteIndex.clear();
+			m_PaletteCounts.clear();
+
 			if (m_BitsPerBlock < 9){
 				VarInt paletteLength;
 				in >> paletteLength;
 
-				m_Palette.reserve(paletteLength.GetInt());
+				// An indirect palette can't have more entries than its indices can address.
+				s32 paletteValues[1 << 8];
+				std::size_t paletteSize = (std::size_t)paletteLength.GetInt();
 
-				for (s32 i = 0; i < paletteLength.GetInt(); ++i){
-					VarInt paletteValue;
-					in >> paletteValue;
-					m_Palette.push_back((u16)paletteValue.GetInt());
+				if (paletteSize > (std::size_t)(1 << m_BitsPerBlock))
+					throw std::runtime_error("Chunk section palette is too large.");
+
+				ReadVarInts(in, paletteValues, paletteSize);
+
+				m_Palette.reserve(paletteSize);
+
+				for (std::size_t i = 0; i < paletteSize; ++i){
+					m_Palette.push_back((u16)paletteValues[i]);
 				}
 			}
 
 			VarInt dataArrayLength;
 			in >> dataArrayLength;
 
-			m_Data.resize(dataArrayLength.GetInt());
+			if (dataArrayLength.GetInt() < 0 || (std::size_t)dataArrayLength.GetInt() > in.GetRemaining() / sizeof(u64))
+				throw std::runtime_error("Chunk section data array is larger than the packet.");
 
-			for (s32 i = 0; i < dataArrayLength.GetInt(); ++i){
-				u64 data;
-				in >> data;
-				m_Data[i] = data;
-			}
-
-			if(version > protocol::Version::Minecraft_1_15_2){
-				//in 1.16 the data entries no longer span accross multiple longs
-				//for compatibility, we span entries accross multiple longs like before
-				//it works but maybe there is an easier way to do that ?
-				const int longBitNumber = sizeof(u64) * 8;
-				if(longBitNumber % m_BitsPerBlock != 0){
-					//need to offset the entries because they don't fit perfectly
-					std::vector<u64> newData(((16 * 16 * 16 * m_BitsPerBlock) / sizeof(u64)) + 1, 0);
-
-					int blocksPerLong = longBitNumber / m_BitsPerBlock;
-
-					u64 shiftingFLag = 0xFFFFFFFF >> (64 - m_BitsPerBlock);
-
-					//long where the entry should be
-					int currentLong = 0;
-					//offset of the entry in the long
-					int longOffset = 0;
-
-					for(int blockIndex = 0; blockIndex < 16 * 16 * 16; blockIndex++){
-						u64 blockLong = m_Data[blockIndex / (blocksPerLong)];
-						u64 blockData = (blockLong >> (m_BitsPerBlock * (blockIndex % blocksPerLong))) & shiftingFLag;
-						if(longBitNumber - longOffset < m_BitsPerBlock){
-							//need to overfill the next long
-							newData[currentLong] |= (blockData << longOffset);
-							newData[currentLong + 1] |= (blockData >> (m_BitsPerBlock - (longOffset + m_BitsPerBlock - longBitNumber)));
-						}else{
-							//entry fit in the current long
-							newData[currentLong] |= (blockData << longOffset);
-						}
-						longOffset += m_BitsPerBlock;
-						if(longOffset >= longBitNumber){
-							longOffset -= longBitNumber;
-							currentLong++;
-						}
-					}
-					m_Data = newData;
-				}
-			}
+			if ((std::size_t)dataArrayLength.GetInt() < GetDataSize(m_BitsPerBlock, m_Layout))
+				throw std::runtime_error("Chunk section data array is too small for its bits per block.");
 
-			if (version <= protocol::Version::Minecraft_1_13_2){
-				static const s64 lightSize = 16 * 16 * 16 / 2;
+			if (m_Palette.size() == 1){
+				// Every index has to be 0, so the data doesn't need to be kept.
+				SetSingleValue(m_Palette[0]);
+				in.SetReadOffset(in.GetReadOffset() + dataArrayLength.GetInt() * sizeof(u64));
+				return;
+			}
 
-				// Block light data
-				in.SetReadOffset(in.GetReadOffset() + lightSize);
+			m_Data.resize(dataArrayLength.GetInt());
+			in.ReadBigEndianArray(m_Data.data(), m_Data.size());
 
-				// Sky Light
-				if (meta->skylight){
-					in.SetReadOffset(in.GetReadOffset() + lightSize);
-				}
+			// Vanilla always puts air in the palette, so uniform sections like solid stone arrive with two entries.
+			if (HasSingleEntry()){
+				SetSingleValue(GetStateId(0));
 			}
 		}
 
@@ -117,76 +401,247 @@ namespace mc{
 			}
 
 			const std::size_t index = (std::size_t)(chunkPosition.y * 16 * 16 + chunkPosition.z * 16 + chunkPosition.x);
-			const s32 bitIndex = index * m_BitsPerBlock;
-			const s32 startIndex = bitIndex / 64;
-			const s32 endIndex = (((index + 1) * m_BitsPerBlock) - 1) / 64;
-			const s32 startSubIndex = bitIndex % 64;
 
-			const s64 maxValue = (1 << m_BitsPerBlock) - 1;
-			u32 value;
+			return block::BlockRegistry::GetInstance()->GetBlock(GetStateId(index));
+		}
 
-			if (startIndex == endIndex){
-				value = (u32)((m_Data[startIndex] >> startSubIndex) & maxValue);
+		u32 Chunk::GetStateId(std::size_t index) const{
+			if (m_Data.empty()){
+				return m_SingleValue;
 			}
-			else{
-				const s32 endSubIndex = 64 - startSubIndex;
 
-				value = (u32)(((m_Data[startIndex] >> startSubIndex) | (m_Data[endIndex] << endSubIndex)) & maxValue);
+			const u32 value = GetEntry(index);
+
+			if (m_BitsPerBlock >= 9){
+				return value;
+			}
+
+			return value < m_Palette.size() ? m_Palette[value] : 0;
+		}
+
+		void Chunk::GetStateIds(std::size_t begin, std::size_t count, u32* out) const{
+			if (m_Data.empty()){
+				std::fill_n(out, count, m_SingleValue);
+				return;
 			}
 
-			const u16 blockType = m_BitsPerBlock < 9 ? m_Palette[value] : value;
+			m_Access->unpack(m_Data.data(), begin, count, out);
 
-			return block::BlockRegistry::GetInstance()->GetBlock(blockType);
+			if (m_BitsPerBlock >= 9){
+				return;
+			}
+
+			const std::size_t paletteSize = m_Palette.size();
+
+			for (std::size_t i = 0; i < count; ++i){
+				out[i] = out[i] < paletteSize ? m_Palette[out[i]] : 0;
+			}
 		}
 
-		void Chunk::SetBlock(Vector3i chunkPosition, block::BlockPtr block){
-			std::size_t index = (std::size_t)(chunkPosition.y * 16 * 16 + chunkPosition.z * 16 + chunkPosition.x);
-			s32 bitIndex = index * m_BitsPerBlock;
-			s32 startIndex = bitIndex / 64;
-			s32 endIndex = (((index + 1) * m_BitsPerBlock) - 1) / 64;
-			s32 startSubIndex = bitIndex % 64;
+		void Chunk::FindStateIds(const std::set<u32>& stateIds, std::size_t begin, std::size_t count, std::vector<u16>& indices) const{
+			if (stateIds.empty() || count == 0){
+				return;
+			}
 
-			s64 maxValue = (1 << m_BitsPerBlock) - 1;
-			u32 blockType = block->GetType();
+			if (m_Data.empty()){
+				if (stateIds.count(m_SingleValue)){
+					for (std::size_t i = begin; i < begin + count; ++i){
+						indices.push_back((u16)i);
+					}
+				}
+				return;
+			}
+
+			const u32 lowest = *stateIds.begin();
+			const u32 highest = *stateIds.rbegin();
+			u32 entries[16 * 16 * 16];
 
-			if (m_BitsPerBlock == 0){
-				m_BitsPerBlock = 4;
+			if (m_BitsPerBlock >= 9){
+				m_Access->unpack(m_Data.data(), begin, count, entries);
+
+				for (std::size_t i = 0; i < count; ++i){
+					if (entries[i] >= lowest && entries[i] <= highest && stateIds.count(entries[i])){
+						indices.push_back((u16)(begin + i));
+					}
+				}
+				return;
 			}
 
+			// Match against the palette once, then compare palette indices instead of state ids.
+			bool matches[1 << 8] = {};
+			bool any = false;
+
+			for (std::size_t i = 0; i < m_Palette.size(); ++i){
+				matches[i] = m_Palette[i] >= lowest && m_Palette[i] <= highest && stateIds.count(m_Palette[i]) != 0;
+				any |= matches[i];
+			}
+
+			if (!any){
+				return;
+			}
+
+			m_Access->unpack(m_Data.data(), begin, count, entries);
+
+			for (std::size_t i = 0; i < count; ++i){
+				// Out of range indices read as air, which is only in the palette if it was matched above.
+				if (entries[i] < m_Palette.size() ? matches[entries[i]] : stateIds.count(0) != 0){
+					indices.push_back((u16)(begin + i));
+				}
+			}
+		}
+
+		void Chunk::SetBlock(Vector3i chunkPosition, block::BlockPtr block){
+			std::size_t index = (std::size_t)(chunkPosition.y * 16 * 16 + chunkPosition.z * 16 + chunkPosition.x);
+			u32 blockType = block->GetType();
+
 			if (m_Data.empty()){
-				m_Palette.push_back(0);
-				u32 size = (16 * 16 * 16) * m_BitsPerBlock / 64;
+				if (blockType == m_SingleValue) return;
 
-				m_Data.resize(size);
-				memset(&m_Data[0], 0, size * sizeof(m_Data[0]));
+				Promote();
 			}
 
-			auto iter = std::find_if(m_Palette.begin(), m_Palette.end(), [blockType](u32 ptype){
-				return ptype == blockType;
-				});
+			const u32 entry = GetOrAddPaletteIndex(blockType);
 
-			if (iter == m_Palette.end())
-				iter = m_Palette.insert(m_Palette.end(), blockType);
+			if (m_BitsPerBlock >= 9){
+				SetEntry(index, entry);
+				return;
+			}
 
-			s32 value = std::distance(m_Palette.begin(), iter);
+			if (m_PaletteCounts.empty()){
+				CountPaletteEntries();
+			}
 
-			// Erase old value in data entry and OR with new data
-			m_Data[startIndex] = (m_Data[startIndex] & ~(maxValue << startSubIndex)) | (((s64)value & maxValue) << startSubIndex);
+			const u32 previous = GetEntry(index);
+			if (previous == entry) return;
 
-			if (startIndex != endIndex){
-				s32 endSubIndex = 64 - startSubIndex;
+			m_PaletteCounts.resize(m_Palette.size(), 0);
+			if (previous < m_PaletteCounts.size()) --m_PaletteCounts[previous];
+			++m_PaletteCounts[entry];
 
-				// Erase beginning of data and then OR with new data
-				m_Data[endIndex] = (m_Data[endIndex] >> endSubIndex << endSubIndex) | ((s64)value & maxValue) >> endSubIndex;
+			if (m_PaletteCounts[entry] == BlocksPerChunk){
+				SetSingleValue(blockType);
+				return;
 			}
+
+			SetEntry(index, entry);
 		}
 
 		ChunkColumn::ChunkColumn(ChunkColumnMetadata metadata, protocol::Version protocolVersion)
-			: m_Metadata(metadata), m_ProtocolVersion(protocolVersion){
+			: m_Metadata(metadata), m_StateSummaryComplete(false), m_Light(metadata.skylight), m_ProtocolVersion(protocolVersion){
 			for (std::size_t i = 0; i < m_Chunks.size(); ++i)
 				m_Chunks[i] = nullptr;
 		}
 
+		void ChunkColumn::UpdateHeightmaps(){
+			const Heightmap::Type types[] = { Heightmap::Type::MotionBlocking, Heightmap::Type::WorldSurface };
+			// Columns of each heightmap that already found their highest block.
+			bool found[2][16 * 16] = {};
+			std::size_t remaining = 2 * 16 * 16;
+			u32 states[16 * 16 * 16];
+			const block::BlockRegistry* registry = block::BlockRegistry::GetInstance();
+
+			m_Heightmaps.fill(Heightmap());
+
+			for (s32 section = ChunksPerColumn - 1; section >= 0 && remaining > 0; --section){
+				const Chunk* chunk = m_Chunks[section].get();
+
+				if (!chunk || (chunk->IsSingleValue() && chunk->GetSingleValue() == 0)) continue;
+
+				chunk->GetStateIds(0, 16 * 16 * 16, states);
+
+				for (s32 column = 0; column < 16 * 16; ++column){
+					for (std::size_t type = 0; type < 2; ++type){
+						if (found[type][column]) continue;
+
+						// column is z * 16 + x, so the block at height y is at y * 256 + column.
+						for (s32 y = 15; y >= 0; --y){
+							if (IsHeightmapBlock(registry, types[type], states[(y << 8) | column])){
+								m_Heightmaps[type].Set(column & 15, column >> 4, section * 16 + y + 1);
+								found[type][column] = true;
+								--remaining;
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void ChunkColumn::UpdateHeight(s32 x, s32 y, s32 z, u32 stateId){
+			if (y < 0 || y >= ChunksPerColumn * 16) return;
+
+			const Heightmap::Type types[] = { Heightmap::Type::MotionBlocking, Heightmap::Type::WorldSurface };
+			const block::BlockRegistry* registry = block::BlockRegistry::GetInstance();
+
+			for (Heightmap::Type type : types){
+				Heightmap& heightmap = GetHeightmap(type);
+				const s32 height = heightmap.Get(x, z);
+
+				if (IsHeightmapBlock(registry, type, stateId)){
+					if (y + 1 > height){
+						heightmap.Set(x, z, y + 1);
+					}
+				}else if (y + 1 == height){
+					// The highest block was removed, so look for the next one below it.
+					heightmap.Set(x, z, FindHeight(registry, type, x, y - 1, z));
+				}
+			}
+		}
+
+		s32 ChunkColumn::FindHeight(const block::BlockRegistry* registry, Heightmap::Type type, s32 x, s32 top, s32 z) const{
+			for (s32 y = top; y >= 0; ){
+				const Chunk* chunk = m_Chunks[y >> 4].get();
+
+				if (!chunk || (chunk->IsSingleValue() && !IsHeightmapBlock(registry, type, chunk->GetSingleValue()))){
+					// Skip to the top of the section below.
+					y = (y & ~15) - 1;
+					continue;
+				}
+
+				if (IsHeightmapBlock(registry, type, chunk->GetStateId((std::size_t)(((y & 15) << 8) | (z << 4) | x)))){
+					return y + 1;
+				}
+
+				--y;
+			}
+
+			return 0;
+		}
+
+		void ChunkColumn::UpdateStateSummary(){
+			m_StateSummary.clear();
+			m_StateSummaryComplete = true;
+
+			for (const ChunkPtr& chunk : m_Chunks){
+				if (!chunk){
+					AddToStateSummary(0);
+				}else if (chunk->IsSingleValue()){
+					AddToStateSummary(chunk->GetSingleValue());
+				}else if (chunk->GetBitsPerBlock() < 9){
+					for (u32 stateId : chunk->GetPalette()){
+						AddToStateSummary(stateId);
+					}
+				}else{
+					// Sections of global ids have no cheap list of their states.
+					m_StateSummary.clear();
+					m_StateSummaryComplete = false;
+					return;
+				}
+			}
+		}
+
+		void ChunkColumn::AddToStateSummary(u32 stateId){
+			if (!m_StateSummaryComplete){
+				return;
+			}
+
+			if ((stateId >> 6) >= m_StateSummary.size()){
+				m_StateSummary.resize((stateId >> 6) + 1, 0);
+			}
+
+			m_StateSummary[stateId >> 6] |= 1ULL << (stateId & 63);
+		}
+
 		block::BlockPtr ChunkColumn::GetBlock(Vector3i position){
 			s32 chunkIndex = (s32)(position.y / 16);
 			Vector3i relativePosition(position.x, position.y % 16, position.z);
@@ -220,12 +675,23 @@ namespace mc{
 					column.m_Chunks[i] = std::make_shared<Chunk>();
 
 					column.m_Chunks[i]->Load(in, meta, i, column.GetProtocolVersion());
+
+					// Light moved to its own packet in 1.14.
+					if (column.GetProtocolVersion() <= protocol::Version::Minecraft_1_13_2){
+						column.m_Light.SetBlockLight(i, ReadLight(in));
+
+						if (meta->skylight){
+							column.m_Light.SetSkyLight(i, ReadLight(in));
+						}
+					}
 				}else{
 					// Air section, leave null
 					column.m_Chunks[i] = nullptr;
 				}
 			}
 
+			column.UpdateStateSummary();
+
 			return in;
 		}
 
@@ -0,0 +1,110 @@
+#include <mclib/world/ChunkMap.h>
+
+namespace {
+
+// Smallest table that gets allocated, 16 slots.
+const u32 MinBits = 4;
+
+} // ns
+
+namespace mc {
+namespace world {
+
+ChunkMap::ChunkMap()
+    : m_Size(0),
+      m_Bits(0)
+{
+}
+
+void ChunkMap::Rehash(u32 bits) {
+    std::vector<Slot> old(std::size_t(1) << bits);
+
+    old.swap(m_Slots);
+    m_Bits = bits;
+
+    std::size_t mask = GetMask();
+
+    for (Slot& slot : old) {
+        if (!slot.used) continue;
+
+        std::size_t i = GetHome(slot.entry.first.first, slot.entry.first.second);
+
+        while (m_Slots[i].used)
+            i = (i + 1) & mask;
+
+        m_Slots[i].entry = std::move(slot.entry);
+        m_Slots[i].used = true;
+    }
+}
+
+void ChunkMap::Reserve(std::size_t count) {
+    u32 bits = MinBits;
+
+    // Keep at least half of the slots empty so probe sequences stay short.
+    while ((std::size_t(1) << bits) < count * 2)
+        ++bits;
+
+    if (bits > m_Bits)
+        Rehash(bits);
+}
+
+void ChunkMap::Insert(s32 x, s32 z, ChunkColumnPtr column) {
+    if (m_Slots.empty() || (m_Size + 1) * 2 > m_Slots.size())
+        Reserve(m_Size + 1);
+
+    std::size_t mask = GetMask();
+    std::size_t i = GetHome(x, z);
+
+    for (; m_Slots[i].used; i = (i + 1) & mask) {
+        if (m_Slots[i].entry.first.first == x && m_Slots[i].entry.first.second == z) {
+            m_Slots[i].entry.second = std::move(column);
+            return;
+        }
+    }
+
+    m_Slots[i].entry = value_type(ChunkCoord(x, z), std::move(column));
+    m_Slots[i].used = true;
+    ++m_Size;
+}
+
+bool ChunkMap::Erase(s32 x, s32 z) {
+    if (m_Size == 0) return false;
+
+    std::size_t mask = GetMask();
+    std::size_t hole = GetHome(x, z);
+
+    while (true) {
+        if (!m_Slots[hole].used) return false;
+        if (m_Slots[hole].entry.first.first == x && m_Slots[hole].entry.first.second == z) break;
+
+        hole = (hole + 1) & mask;
+    }
+
+    // Move back every following entry of the probe run that would no longer be reachable across the hole.
+    for (std::size_t i = (hole + 1) & mask; m_Slots[i].used; i = (i + 1) & mask) {
+        std::size_t home = GetHome(m_Slots[i].entry.first.first, m_Slots[i].entry.first.second);
+
+        // Distance from the entry's home slot to where it is now, and to the hole, wrapping around the table.
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            m_Slots[hole].entry = std::move(m_Slots[i].entry);
+            hole = i;
+        }
+    }
+
+    m_Slots[hole].entry = value_type();
+    m_Slots[hole].used = false;
+    --m_Size;
+    return true;
+}
+
+void ChunkMap::Clear() {
+    for (Slot& slot : m_Slots) {
+        slot.entry = value_type();
+        slot.used = false;
+    }
+
+    m_Size = 0;
+}
+
+} // ns world
+} // ns mc
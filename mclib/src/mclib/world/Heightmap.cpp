@@ -0,0 +1,41 @@
+#include <mclib/world/Heightmap.h>
+
+namespace mc {
+namespace world {
+
+Heightmap::Heightmap() {
+    m_Data.fill(0);
+}
+
+bool Heightmap::Load(const std::vector<s64>& data, bool aligned) {
+    if (aligned) {
+        if (data.size() != LongCount) return false;
+
+        for (std::size_t i = 0; i < data.size(); ++i)
+            m_Data[i] = (u64)data[i];
+
+        return true;
+    }
+
+    if (data.size() != (16 * 16 * Bits + 63) / 64) return false;
+
+    const u64 mask = (1 << Bits) - 1;
+
+    for (s32 index = 0; index < 16 * 16; ++index) {
+        const std::size_t bit = (std::size_t)index * Bits;
+        const std::size_t start = bit / 64;
+        const std::size_t offset = bit % 64;
+
+        u64 value = (u64)data[start] >> offset;
+
+        if (offset + Bits > 64)
+            value |= (u64)data[start + 1] << (64 - offset);
+
+        Set(index & 15, index >> 4, (s32)(value & mask));
+    }
+
+    return true;
+}
+
+} // ns world
+} // ns mc
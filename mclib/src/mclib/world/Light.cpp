@@ -0,0 +1,65 @@
+#include <mclib/world/Light.h>
+
+#include <algorithm>
+
+namespace mc {
+namespace world {
+
+const std::shared_ptr<const NibbleArray::Bytes>& NibbleArray::GetUniform(u8 level) {
+    static const std::array<std::shared_ptr<const Bytes>, 16> uniform = [] {
+        std::array<std::shared_ptr<const Bytes>, 16> arrays;
+
+        for (u8 i = 0; i < 16; ++i) {
+            auto bytes = std::make_shared<Bytes>();
+            bytes->fill((u8)(i | (i << 4)));
+            arrays[i] = bytes;
+        }
+
+        return arrays;
+    }();
+
+    return uniform[level & 15];
+}
+
+NibbleArray::NibbleArray(u8 level)
+    : m_Data(GetUniform(level))
+{
+}
+
+NibbleArray::NibbleArray(const u8* data) {
+    const u8 first = data[0];
+
+    if ((first & 15) == (first >> 4) && std::all_of(data, data + Size, [first](u8 value) { return value == first; })) {
+        m_Data = GetUniform(first & 15);
+        return;
+    }
+
+    auto bytes = std::make_shared<Bytes>();
+    std::copy_n(data, (std::size_t)Size, bytes->begin());
+    m_Data = std::move(bytes);
+}
+
+bool NibbleArray::IsUniform() const noexcept {
+    const u8 first = (*m_Data)[0];
+
+    return (first & 15) == (first >> 4) && m_Data == GetUniform(first & 15);
+}
+
+ColumnLight::ColumnLight(bool skylight) {
+    m_SkyLight.fill(NibbleArray(skylight ? 15 : 0));
+}
+
+void ColumnLight::SetSkyLight(s32 section, const NibbleArray& light) {
+    if (section < -1 || section + 1 >= SectionCount) return;
+
+    m_SkyLight[section + 1] = light;
+}
+
+void ColumnLight::SetBlockLight(s32 section, const NibbleArray& light) {
+    if (section < -1 || section + 1 >= SectionCount) return;
+
+    m_BlockLight[section + 1] = light;
+}
+
+} // ns world
+} // ns mc
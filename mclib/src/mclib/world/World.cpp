@@ -1,5 +1,7 @@
 #include <mclib/world/World.h>
 
+#include <algorithm>
+
 namespace mc{
 	namespace world{
 
@@ -12,6 +14,7 @@ namespace mc{
 			dispatcher->RegisterHandler(protocol::State::Play, protocol::play::Explosion, this);
 			dispatcher->RegisterHandler(protocol::State::Play, protocol::play::UpdateBlockEntity, this);
 			dispatcher->RegisterHandler(protocol::State::Play, protocol::play::Respawn, this);
+			dispatcher->RegisterHandler(protocol::State::Play, protocol::play::UpdateLight, this);
 		}
 
 		World::~World(){
@@ -19,18 +22,10 @@ namespace mc{
 		}
 
 		bool World::SetBlock(Vector3i position, u32 blockData){
-			ChunkColumnPtr chunk = GetChunk(position);
+			ChunkColumn* chunk = GetChunkColumn(position);
 			if (!chunk) return false;
 
-			Vector3i relative(position);
-
-			relative.x %= 16;
-			relative.z %= 16;
-
-			if (relative.x < 0)
-				relative.x += 16;
-			if (relative.z < 0)
-				relative.z += 16;
+			Vector3i relative(position.x & 15, position.y, position.z & 15);
 
 			std::size_t index = (std::size_t)position.y / 16;
 			if ((*chunk)[index] == nullptr){
@@ -40,7 +35,10 @@ namespace mc{
 			}
 
 			relative.y %= 16;
-			(*chunk)[index]->SetBlock(relative, block::BlockRegistry::GetInstance()->GetBlock(blockData));
+			block::BlockPtr block = block::BlockRegistry::GetInstance()->GetBlock(blockData);
+			(*chunk)[index]->SetBlock(relative, block);
+			chunk->AddToStateSummary(block->GetType());
+			chunk->UpdateHeight((s32)relative.x, (s32)position.y, (s32)relative.z, block->GetType());
 			return true;
 		}
 
@@ -63,28 +61,45 @@ namespace mc{
 		void World::HandlePacket(protocol::packets::in::ChunkDataPacket* packet){
 			ChunkColumnPtr col = packet->GetChunkColumn();
 			const ChunkColumnMetadata& meta = col->GetMetadata();
-			ChunkCoord key(meta.x, meta.z);
-
 			if (meta.sectionmask == 0){
-				m_Chunks[key] = nullptr;
+				m_Chunks.Insert(meta.x, meta.z, nullptr);
 				return;
 			}
 
-			auto iter = m_Chunks.find(key);
-
 			if (!meta.continuous){
-				assert(iter != m_Chunks.end());
+				ChunkColumn* existing = m_Chunks.Find(meta.x, meta.z);
+				assert(existing != nullptr);
 
 				// This isn't an entire column of chunks, so just update the existing chunk column with the provided chunks.
 				for (s16 i = 0; i < ChunkColumn::ChunksPerColumn; ++i){
 					// The section mask says whether or not there is data in this chunk.
 					if (meta.sectionmask & (1 << i)){
-						(*iter->second)[i] = (*col)[i];
+						(*existing)[i] = (*col)[i];
 					}
 				}
+
+				existing->UpdateStateSummary();
+				// The column's heightmaps were computed from only the sections in this packet.
+				existing->UpdateHeightmaps();
 			}else{
+				// Since 1.14 light is sent before the chunk data, so a column that is already loaded has the newest light.
+				const ChunkColumn* existing = m_Chunks.Find(meta.x, meta.z);
+				if (existing && col->GetProtocolVersion() >= protocol::Version::Minecraft_1_14_2){
+					col->GetLight() = existing->GetLight();
+				}
+
 				// This is an entire column of chunks, so just replace the entire column with the new one.
-				m_Chunks[key] = col;
+				m_Chunks.Insert(meta.x, meta.z, col);
+
+				auto pending = m_PendingLight.find(ChunkMap::ChunkCoord(meta.x, meta.z));
+				if (pending != m_PendingLight.end()){
+					for (const auto& section : pending->second.sky)
+						col->GetLight().SetSkyLight(section.first, section.second);
+					for (const auto& section : pending->second.block)
+						col->GetLight().SetBlockLight(section.first, section.second);
+
+					m_PendingLight.erase(pending);
+				}
 			}
 
 			for (s32 i = 0; i < ChunkColumn::ChunksPerColumn; ++i){
@@ -96,10 +111,7 @@ namespace mc{
 
 		void World::HandlePacket(protocol::packets::in::MultiBlockChangePacket* packet){
 			Vector3i chunkStart(packet->GetChunkX() * 16, 0, packet->GetChunkZ() * 16);
-			auto iter = m_Chunks.find(ChunkCoord(packet->GetChunkX(), packet->GetChunkZ()));
-			if (iter == m_Chunks.end()) return;
-
-			ChunkColumnPtr chunk = iter->second;
+			ChunkColumn* chunk = m_Chunks.Find(packet->GetChunkX(), packet->GetChunkZ());
 			if (!chunk)
 				return;
 
@@ -125,6 +137,8 @@ namespace mc{
 
 				relative.y %= 16;
 				(*chunk)[index]->SetBlock(relative, newBlock);
+				chunk->AddToStateSummary(newBlock->GetType());
+				chunk->UpdateHeight(change.x, change.y, change.z, newBlock->GetType());
 				NotifyListeners(&WorldListener::OnBlockChange, blockChangePos, newBlock, oldBlock);
 			}
 		}
@@ -158,39 +172,82 @@ namespace mc{
 		}
 
 		void World::HandlePacket(protocol::packets::in::UnloadChunkPacket* packet){
-			ChunkCoord coord(packet->GetChunkX(), packet->GetChunkZ());
+			// Light can arrive for columns whose chunk data never does.
+			m_PendingLight.erase(ChunkMap::ChunkCoord(packet->GetChunkX(), packet->GetChunkZ()));
 
-			auto iter = m_Chunks.find(coord);
+			const ChunkColumnPtr* entry = m_Chunks.FindEntry(packet->GetChunkX(), packet->GetChunkZ());
 
-			if (iter == m_Chunks.end()) return;
+			if (!entry) return;
 
-			ChunkColumnPtr chunk = iter->second;
+			ChunkColumnPtr chunk = *entry;
 			NotifyListeners(&WorldListener::OnChunkUnload, chunk);
 
-			m_Chunks.erase(iter);
+			m_Chunks.Erase(packet->GetChunkX(), packet->GetChunkZ());
 		}
 
 		// Clear all chunks because the server will resend the chunks after this.
 		void World::HandlePacket(protocol::packets::in::RespawnPacket* packet){
-			for (auto entry : m_Chunks){
+			for (const auto& entry : m_Chunks){
 				ChunkColumnPtr chunk = entry.second;
 
 				NotifyListeners(&WorldListener::OnChunkUnload, chunk);
 			}
-			m_Chunks.clear();
+			m_Chunks.Clear();
+			m_PendingLight.clear();
 		}
 
-		ChunkColumnPtr World::GetChunk(Vector3i pos) const{
-			s32 x = (s32)std::floor(pos.x / 16.0);
-			s32 z = (s32)std::floor(pos.z / 16.0);
+		void World::HandlePacket(protocol::packets::in::UpdateLightPacket* packet){
+			ChunkColumn* column = m_Chunks.Find(packet->GetChunkX(), packet->GetChunkZ());
+
+			if (column){
+				packet->Apply(column->GetLight());
+				return;
+			}
+
+			PendingLight& pending = m_PendingLight[ChunkMap::ChunkCoord(packet->GetChunkX(), packet->GetChunkZ())];
+
+			pending.sky.insert(pending.sky.end(), packet->GetSkyLight().begin(), packet->GetSkyLight().end());
+			pending.block.insert(pending.block.end(), packet->GetBlockLight().begin(), packet->GetBlockLight().end());
+		}
+
+		u8 World::GetSkyLight(Vector3i pos) const{
+			const ChunkColumn* column = GetChunkColumn(pos);
+
+			if (!column) return 0;
 
-			ChunkCoord key(x, z);
+			return column->GetLight().GetSkyLight((s32)(pos.x & 15), (s32)pos.y, (s32)(pos.z & 15));
+		}
 
-			auto iter = m_Chunks.find(key);
+		u8 World::GetBlockLight(Vector3i pos) const{
+			const ChunkColumn* column = GetChunkColumn(pos);
 
-			if (iter == m_Chunks.end()) return nullptr;
+			if (!column) return 0;
 
-			return iter->second;
+			return column->GetLight().GetBlockLight((s32)(pos.x & 15), (s32)pos.y, (s32)(pos.z & 15));
+		}
+
+		s32 World::GetHeight(s64 x, s64 z, Heightmap::Type type) const{
+			const ChunkColumn* column = m_Chunks.Find((s32)(x >> 4), (s32)(z >> 4));
+
+			if (!column) return 0;
+
+			return column->GetHeightmap(type).Get((s32)(x & 15), (s32)(z & 15));
+		}
+
+		void World::SetViewDistance(s32 distance){
+			// The server sends one ring of columns past the view distance.
+			std::size_t diameter = (std::size_t)std::max(distance, 0) * 2 + 3;
+
+			m_Chunks.Reserve(diameter * diameter);
+		}
+
+		ChunkColumnPtr World::GetChunk(Vector3i pos) const{
+			// Arithmetic shifts floor negative coordinates into the right column.
+			const ChunkColumnPtr* entry = m_Chunks.FindEntry((s32)(pos.x >> 4), (s32)(pos.z >> 4));
+
+			if (!entry) return nullptr;
+
+			return *entry;
 		}
 
 		block::BlockPtr World::GetBlock(Vector3f pos) const{
@@ -202,19 +259,74 @@ namespace mc{
 		}
 
 		block::BlockPtr World::GetBlock(Vector3i pos) const{
-			ChunkColumnPtr col = GetChunk(pos);
+			ChunkColumn* col = GetChunkColumn(pos);
 
 			if (!col) return block::BlockRegistry::GetInstance()->GetBlock(0);
 
-			s64 x = pos.x % 16;
-			s64 z = pos.z % 16;
+			return col->GetBlock(Vector3i(pos.x & 15, pos.y, pos.z & 15));
+		}
+
+		std::vector<Vector3i> World::FindBlocks(const std::set<u32>& stateIds, Vector3i min, Vector3i max) const{
+			std::vector<Vector3i> found;
+
+			if (stateIds.empty() || min.x >= max.x || min.y >= max.y || min.z >= max.z) return found;
+
+			// Missing sections are air, which the default section is.
+			static const Chunk air;
+
+			const s64 minSection = std::max<s64>(min.y >> 4, 0);
+			const s64 maxSection = std::min<s64>((max.y - 1) >> 4, ChunkColumn::ChunksPerColumn - 1);
+			std::vector<u16> indices;
+
+			for (s64 cz = min.z >> 4; cz <= (max.z - 1) >> 4; ++cz){
+				for (s64 cx = min.x >> 4; cx <= (max.x - 1) >> 4; ++cx){
+					const ChunkColumn* column = m_Chunks.Find((s32)cx, (s32)cz);
+					if (!column) continue;
+
+					bool mayContain = false;
+					for (u32 stateId : stateIds){
+						if (column->MayContain(stateId)){
+							mayContain = true;
+							break;
+						}
+					}
+
+					if (!mayContain) continue;
+
+					const Vector3i origin(cx * 16, 0, cz * 16);
+					const s64 minX = std::max(min.x, origin.x) - origin.x;
+					const s64 minZ = std::max(min.z, origin.z) - origin.z;
+					const s64 maxX = std::min(max.x, origin.x + 16) - origin.x;
+					const s64 maxZ = std::min(max.z, origin.z + 16) - origin.z;
+
+					for (s64 cy = minSection; cy <= maxSection; ++cy){
+						const Chunk* section = (*column)[(std::size_t)cy].get();
+						const s64 minY = std::max<s64>(min.y - cy * 16, 0);
+						const s64 maxY = std::min<s64>(max.y - cy * 16, 16);
+
+						indices.clear();
+						(section ? section : &air)->FindStateIds(stateIds, (std::size_t)(minY * 256), (std::size_t)((maxY - minY) * 256), indices);
+
+						for (u16 index : indices){
+							const s64 x = index & 15;
+							const s64 z = (index >> 4) & 15;
+
+							if (x < minX || x >= maxX || z < minZ || z >= maxZ) continue;
+
+							found.emplace_back(origin.x + x, cy * 16 + (index >> 8), origin.z + z);
+						}
+					}
+				}
+			}
+
+			return found;
+		}
 
-			if (x < 0)
-				x += 16;
-			if (z < 0)
-				z += 16;
+		std::vector<Vector3i> World::FindBlocks(const std::set<u32>& stateIds, const AABB& bounds) const{
+			Vector3i min((s64)std::floor(bounds.min.x), (s64)std::floor(bounds.min.y), (s64)std::floor(bounds.min.z));
+			Vector3i max((s64)std::ceil(bounds.max.x), (s64)std::ceil(bounds.max.y), (s64)std::ceil(bounds.max.z));
 
-			return col->GetBlock(Vector3i(x, pos.y, z));
+			return FindBlocks(stateIds, min, max);
 		}
 
 		block::BlockEntityPtr World::GetBlockEntity(Vector3i pos) const{
@@ -0,0 +1,96 @@
+#include "catch.hpp"
+#include "WorldHelpers.h"
+
+#include <mclib/world/BlockAccessor.h>
+
+#include <vector>
+
+using helpers::GetPatternState;
+
+TEST_CASE("BlockAccessor reads the same blocks as World", "[BlockAccessor]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    fixture.LoadColumn(helpers::CreatePatternColumn(-1));
+    fixture.LoadColumn(helpers::CreatePatternColumn(0));
+
+    mc::world::BlockAccessor blocks(world);
+
+    // Walks across loaded, empty and unloaded sections in both directions.
+    for (s64 y = -2; y < 52; ++y) {
+        for (s64 z = -3; z < 19; ++z) {
+            for (s64 x = -19; x < 19; ++x) {
+                u32 expected = GetPatternState(x, y, z);
+
+                REQUIRE(blocks.GetStateId(x, y, z) == expected);
+                REQUIRE(blocks.Get(x, y, z) == world.GetBlock(mc::Vector3i(x, y, z)));
+                REQUIRE(blocks.IsSolid(x, y, z) == (expected != 0));
+            }
+        }
+    }
+}
+
+TEST_CASE("BlockAccessor moves its cursor and visits neighbors", "[BlockAccessor]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    fixture.LoadColumn(helpers::CreatePatternColumn(-1));
+    fixture.LoadColumn(helpers::CreatePatternColumn(0));
+
+    mc::world::BlockAccessor blocks(world, mc::Vector3i(0, 15, 0));
+
+    REQUIRE(blocks.GetStateId() == GetPatternState(0, 15, 0));
+
+    blocks.Offset(-1, 1, 2);
+    REQUIRE(blocks.GetPosition() == mc::Vector3i(-1, 16, 2));
+    REQUIRE(blocks.GetStateId() == 0);
+
+    blocks.MoveTo(mc::Vector3i(0, 32, 0));
+
+    std::vector<mc::Vector3i> visited;
+    blocks.ForEachNeighbor([&](mc::Vector3i position, u32 stateId) {
+        REQUIRE(stateId == GetPatternState(position.x, position.y, position.z));
+        visited.push_back(position);
+    });
+
+    REQUIRE(visited.size() == 6);
+    REQUIRE(visited[0] == mc::Vector3i(-1, 32, 0));
+    REQUIRE(visited[3] == mc::Vector3i(0, 33, 0));
+    REQUIRE(visited[4] == mc::Vector3i(0, 32, -1));
+}
+
+TEST_CASE("BlockAccessor neighbor walk matches World", "[BlockAccessor]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    for (s32 x = -8; x < 8; ++x)
+        fixture.LoadColumn(helpers::CreatePatternColumn(x));
+
+    std::size_t reference = 0;
+    std::size_t accessor = 0;
+
+    // Counts the solid face neighbors of every block, like a flood fill or mesher would.
+    for (s64 y = 0; y < 48; ++y)
+        for (s64 z = 0; z < 16; ++z)
+            for (s64 x = -16; x < 16; ++x)
+                for (s64 i = 0; i < 6; ++i) {
+                    mc::Vector3i position(x + (i == 0) - (i == 1), y + (i == 2) - (i == 3), z + (i == 4) - (i == 5));
+                    mc::block::BlockPtr block = world.GetBlock(position);
+
+                    reference += block && block->IsSolid();
+                }
+
+    mc::world::BlockAccessor blocks(world);
+
+    for (s64 y = 0; y < 48; ++y)
+        for (s64 z = 0; z < 16; ++z)
+            for (s64 x = -16; x < 16; ++x) {
+                blocks.MoveTo(mc::Vector3i(x, y, z));
+                blocks.ForEachNeighbor([&](mc::Vector3i, u32 stateId) {
+                    accessor += mc::block::BlockRegistry::GetInstance()->IsSolid(stateId);
+                });
+            }
+
+    REQUIRE(reference > 0);
+    REQUIRE(accessor == reference);
+}
@@ -0,0 +1,63 @@
+#include "catch.hpp"
+
+#include <mclib/block/Block.h>
+
+using mc::block::BlockRegistry;
+
+TEST_CASE("BlockRegistry answers state queries from dense tables", "[BlockRegistry]") {
+    BlockRegistry* registry = BlockRegistry::GetInstance();
+
+    registry->ClearRegistry();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+
+    // air and stone
+    REQUIRE(registry->GetBlock(0u)->GetName() == "minecraft:air");
+    REQUIRE(registry->GetBlock(1u)->GetName() == "minecraft:stone");
+
+    REQUIRE_FALSE(registry->IsSolid(0));
+    REQUIRE(registry->IsSolid(1));
+    REQUIRE_FALSE(registry->IsOpaque(0));
+    REQUIRE(registry->IsOpaque(1));
+
+    REQUIRE(registry->GetShapeIndex(0) == 0);
+    const mc::AABB& stone = registry->GetShape(registry->GetShapeIndex(1));
+    REQUIRE(stone.max == mc::Vector3d(1, 1, 1));
+
+    REQUIRE(registry->GetBlock(1u << 20) == nullptr);
+    REQUIRE_FALSE(registry->IsSolid(1u << 20));
+}
+
+TEST_CASE("BlockRegistry falls back to the base id of legacy blocks", "[BlockRegistry]") {
+    BlockRegistry* registry = BlockRegistry::GetInstance();
+
+    registry->ClearRegistry();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_12_2);
+
+    // Stone has metadata 0 to 6, so 15 only exists through its base id.
+    REQUIRE(registry->GetBlock((1u << 4) | 15) == registry->GetBlock(1u << 4));
+    REQUIRE(registry->IsSolid((1u << 4) | 15));
+
+    // The last registered block is the structure block at 4080, its other metas still fall back to it.
+    REQUIRE(registry->GetBlock(4085u) == registry->GetBlock(4080u));
+    REQUIRE(registry->IsSolid(4085) == registry->GetBlock(4080u)->IsSolid());
+    REQUIRE(registry->GetBlock(4096u) == nullptr);
+    REQUIRE_FALSE(registry->IsSolid(4096));
+
+    // Blocks registered one by one update the metas that fall back to them without rebuilding the tables.
+    registry->ClearRegistry();
+    registry->RegisterBlock(new mc::block::Block("test:meta", 8001, true));
+
+    REQUIRE(registry->GetBlock(8005u) == nullptr);
+    REQUIRE_FALSE(registry->IsSolid(8005));
+
+    registry->RegisterBlock(new mc::block::Block("test:base", 8000, true));
+
+    REQUIRE(registry->GetBlock(8005u)->GetName() == "test:base");
+    REQUIRE(registry->IsSolid(8005));
+    REQUIRE(registry->GetBlock(8015u)->GetName() == "test:base");
+    REQUIRE(registry->IsSolid(8015));
+    REQUIRE(registry->GetBlock(8001u)->GetName() == "test:meta");
+
+    registry->ClearRegistry();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+}
@@ -0,0 +1,347 @@
+#include "catch.hpp"
+
+#include <mclib/common/DataBuffer.h>
+#include <mclib/common/VarInt.h>
+#include <mclib/world/Chunk.h>
+
+#include <set>
+#include <vector>
+
+namespace {
+
+const u8 BitsPerBlock = 5;
+const u32 PaletteSize = 1 << BitsPerBlock;
+
+// Serializes a section where block i uses palette entry i % PaletteSize, and the palette maps entry n to state n.
+mc::DataBuffer CreateSection(mc::world::Chunk::Layout layout) {
+    const std::size_t perLong = 64 / BitsPerBlock;
+    std::vector<u64> data(mc::world::Chunk::GetDataSize(BitsPerBlock, layout), 0);
+
+    for (std::size_t i = 0; i < 4096; ++i) {
+        u64 value = i % PaletteSize;
+
+        if (layout == mc::world::Chunk::Layout::Aligned) {
+            data[i / perLong] |= value << ((i % perLong) * BitsPerBlock);
+        } else {
+            std::size_t bit = i * BitsPerBlock;
+            data[bit / 64] |= value << (bit % 64);
+            if (bit % 64 + BitsPerBlock > 64)
+                data[bit / 64 + 1] |= value >> (64 - bit % 64);
+        }
+    }
+
+    mc::DataBuffer buffer;
+    buffer << (u16)4096 << BitsPerBlock << mc::VarInt((s32)PaletteSize);
+    for (u32 i = 0; i < PaletteSize; ++i)
+        buffer << mc::VarInt((s32)i);
+
+    buffer << mc::VarInt((s32)data.size());
+    for (u64 value : data)
+        buffer << value;
+
+    return buffer;
+}
+
+void RequireSection(mc::world::Chunk& chunk) {
+    for (s32 y = 0; y < 16; ++y) {
+        for (s32 z = 0; z < 16; ++z) {
+            for (s32 x = 0; x < 16; ++x) {
+                u32 index = y * 256 + z * 16 + x;
+                mc::block::BlockPtr block = chunk.GetBlock(mc::Vector3i(x, y, z));
+
+                REQUIRE(block != nullptr);
+                REQUIRE(block->GetType() == index % PaletteSize);
+            }
+        }
+    }
+}
+
+} // ns
+
+TEST_CASE("Chunk reads packed sections in both layouts", "[Chunk]") {
+    mc::block::BlockRegistry::GetInstance()->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+
+    mc::world::ChunkColumnMetadata meta = {};
+    mc::world::Chunk chunk;
+
+    SECTION("1.16 sections are kept aligned to longs") {
+        mc::DataBuffer buffer = CreateSection(mc::world::Chunk::Layout::Aligned);
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+        REQUIRE(chunk.GetLayout() == mc::world::Chunk::Layout::Aligned);
+        REQUIRE(buffer.IsFinished());
+        RequireSection(chunk);
+    }
+
+    SECTION("older sections span across longs") {
+        mc::DataBuffer buffer = CreateSection(mc::world::Chunk::Layout::Spanning);
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_15_2);
+
+        REQUIRE(chunk.GetLayout() == mc::world::Chunk::Layout::Spanning);
+        REQUIRE(buffer.IsFinished());
+        RequireSection(chunk);
+
+        // Block 12 starts at bit 60, so it's split across the first two longs.
+        mc::block::BlockPtr stone = mc::block::BlockRegistry::GetInstance()->GetBlock(1);
+        chunk.SetBlock(mc::Vector3i(12, 0, 0), stone);
+
+        REQUIRE(chunk.GetBlock(mc::Vector3i(12, 0, 0))->GetType() == 1);
+        REQUIRE(chunk.GetBlock(mc::Vector3i(11, 0, 0))->GetType() == 11);
+        REQUIRE(chunk.GetBlock(mc::Vector3i(13, 0, 0))->GetType() == 13);
+    }
+
+    SECTION("set blocks can be read back") {
+        mc::DataBuffer buffer = CreateSection(mc::world::Chunk::Layout::Aligned);
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+        mc::block::BlockPtr stone = mc::block::BlockRegistry::GetInstance()->GetBlock(1);
+        chunk.SetBlock(mc::Vector3i(11, 3, 7), stone);
+
+        REQUIRE(chunk.GetBlock(mc::Vector3i(11, 3, 7))->GetType() == 1);
+        REQUIRE(chunk.GetBlock(mc::Vector3i(10, 3, 7))->GetType() == (3 * 256 + 7 * 16 + 10) % PaletteSize);
+        REQUIRE(chunk.GetBlock(mc::Vector3i(0, 3, 7))->GetType() == (3 * 256 + 7 * 16 + 0) % PaletteSize);
+    }
+}
+
+TEST_CASE("Chunk keeps uniform sections as a single value", "[Chunk]") {
+    mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+
+    // A section of only stone, which is state 1.
+    mc::DataBuffer buffer;
+    buffer << (u16)4096 << (u8)4 << mc::VarInt(1) << mc::VarInt(1) << mc::VarInt(256);
+    for (int i = 0; i < 256; ++i)
+        buffer << (u64)0;
+
+    mc::world::ChunkColumnMetadata meta = {};
+    mc::world::Chunk chunk;
+    chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+    REQUIRE(buffer.IsFinished());
+    REQUIRE(chunk.IsSingleValue());
+    REQUIRE(chunk.GetBlock(mc::Vector3i(5, 9, 2))->GetType() == 1);
+
+    chunk.SetBlock(mc::Vector3i(5, 9, 2), registry->GetBlock(1));
+    REQUIRE(chunk.IsSingleValue());
+
+    chunk.SetBlock(mc::Vector3i(5, 9, 2), registry->GetBlock(0));
+    REQUIRE_FALSE(chunk.IsSingleValue());
+    REQUIRE(chunk.GetBlock(mc::Vector3i(5, 9, 2))->GetType() == 0);
+    REQUIRE(chunk.GetBlock(mc::Vector3i(6, 9, 2))->GetType() == 1);
+}
+
+TEST_CASE("Chunk detects uniform sections from their data", "[Chunk]") {
+    mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+
+    mc::world::ChunkColumnMetadata meta = {};
+    mc::world::Chunk chunk;
+
+    SECTION("a palette seeded with air whose entries are all stone") {
+        // 4 bits per block repeated 16 times per long.
+        mc::DataBuffer buffer;
+        buffer << (u16)4096 << (u8)4 << mc::VarInt(2) << mc::VarInt(0) << mc::VarInt(1) << mc::VarInt(256);
+        for (int i = 0; i < 256; ++i)
+            buffer << (u64)0x1111111111111111ULL;
+
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+        REQUIRE(buffer.IsFinished());
+        REQUIRE(chunk.IsSingleValue());
+        REQUIRE(chunk.GetBlock(mc::Vector3i(15, 15, 15))->GetType() == 1);
+    }
+
+    SECTION("sections of other air keep their states") {
+        // Cave air and void air in 1.16.5, which don't count toward the block count.
+        const u32 VoidAir = 9669;
+        const u32 CaveAir = 9670;
+
+        REQUIRE(registry->GetBlock(VoidAir)->GetName() == "minecraft:void_air");
+        REQUIRE(registry->GetBlock(CaveAir)->GetName() == "minecraft:cave_air");
+
+        mc::DataBuffer buffer;
+        buffer << (u16)0 << (u8)4 << mc::VarInt(2) << mc::VarInt(0) << mc::VarInt((s32)CaveAir) << mc::VarInt(256);
+        for (int i = 0; i < 256; ++i)
+            buffer << (u64)0x1111111111111111ULL;
+
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+        REQUIRE(buffer.IsFinished());
+        REQUIRE(chunk.IsSingleValue());
+        REQUIRE(chunk.GetSingleValue() == CaveAir);
+
+        // Mixed air keeps every state.
+        mc::DataBuffer mixed;
+        mixed << (u16)0 << (u8)4 << mc::VarInt(2) << mc::VarInt(0) << mc::VarInt((s32)VoidAir) << mc::VarInt(256);
+        for (int i = 0; i < 256; ++i)
+            mixed << (u64)0x0101010101010101ULL;
+
+        chunk.Load(mixed, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+        REQUIRE(mixed.IsFinished());
+        REQUIRE_FALSE(chunk.IsSingleValue());
+        REQUIRE(chunk.GetStateId(0) == VoidAir);
+        REQUIRE(chunk.GetStateId(1) == 0);
+    }
+
+    SECTION("sections with different blocks keep their data") {
+        mc::DataBuffer buffer;
+        buffer << (u16)4096 << (u8)4 << mc::VarInt(2) << mc::VarInt(0) << mc::VarInt(1) << mc::VarInt(256);
+        for (int i = 0; i < 255; ++i)
+            buffer << (u64)0x1111111111111111ULL;
+        buffer << (u64)0x0111111111111111ULL;
+
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+        REQUIRE_FALSE(chunk.IsSingleValue());
+        REQUIRE(chunk.GetBlock(mc::Vector3i(15, 15, 15))->GetType() == 0);
+
+        // Replacing the last air block makes the section uniform again.
+        chunk.SetBlock(mc::Vector3i(15, 15, 15), registry->GetBlock(1));
+
+        REQUIRE(chunk.IsSingleValue());
+        REQUIRE(chunk.GetBlock(mc::Vector3i(15, 15, 15))->GetType() == 1);
+    }
+
+    SECTION("set blocks demote promoted sections") {
+        chunk.SetBlock(mc::Vector3i(1, 2, 3), registry->GetBlock(1));
+        chunk.SetBlock(mc::Vector3i(4, 5, 6), registry->GetBlock(1));
+
+        REQUIRE_FALSE(chunk.IsSingleValue());
+
+        chunk.SetBlock(mc::Vector3i(1, 2, 3), registry->GetBlock(0));
+        REQUIRE_FALSE(chunk.IsSingleValue());
+
+        chunk.SetBlock(mc::Vector3i(4, 5, 6), registry->GetBlock(0));
+        REQUIRE(chunk.IsSingleValue());
+        REQUIRE(chunk.GetSingleValue() == 0);
+    }
+}
+
+TEST_CASE("Chunk grows its palette while blocks are set", "[Chunk]") {
+    mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+
+    mc::world::Chunk chunk;
+
+    auto fill = [&](u32 states) {
+        for (s32 i = 0; i < 4096; ++i)
+            chunk.SetBlock(mc::Vector3i(i % 16, i / 256, (i / 16) % 16), registry->GetBlock((u32)i % states));
+    };
+
+    auto check = [&](u32 states) {
+        for (s32 i = 0; i < 4096; ++i)
+            REQUIRE(chunk.GetBlock(mc::Vector3i(i % 16, i / 256, (i / 16) % 16))->GetType() == (u32)i % states);
+    };
+
+    SECTION("past 16 states the palette widens") {
+        fill(20);
+
+        REQUIRE(chunk.GetBitsPerBlock() == 5);
+        check(20);
+    }
+
+    SECTION("past 256 states the section switches to global ids") {
+        fill(300);
+
+        REQUIRE(chunk.GetBitsPerBlock() >= 9);
+        check(300);
+    }
+}
+
+TEST_CASE("Chunk decodes runs of state ids in order", "[Chunk]") {
+    mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+
+    mc::world::ChunkColumnMetadata meta = {};
+    mc::world::Chunk chunk;
+
+    auto check = [&]() {
+        const std::size_t ranges[][2] = { { 0, 4096 }, { 12, 1 }, { 11, 40 }, { 256, 512 }, { 4000, 96 } };
+        std::vector<u32> states(4096);
+
+        for (const auto& range : ranges) {
+            chunk.GetStateIds(range[0], range[1], states.data());
+
+            for (std::size_t i = 0; i < range[1]; ++i)
+                REQUIRE(states[i] == chunk.GetStateId(range[0] + i));
+        }
+    };
+
+    auto fill = [&](u32 states) {
+        for (s32 i = 0; i < 4096; ++i)
+            chunk.SetBlock(mc::Vector3i(i % 16, i / 256, (i / 16) % 16), registry->GetBlock((u32)(i * 7) % states));
+    };
+
+    SECTION("single value sections") {
+        check();
+    }
+
+    SECTION("aligned sections") {
+        mc::DataBuffer buffer = CreateSection(mc::world::Chunk::Layout::Aligned);
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+        check();
+
+        fill(300);
+        REQUIRE(chunk.GetBitsPerBlock() >= 9);
+        check();
+    }
+
+    SECTION("spanning sections") {
+        mc::DataBuffer buffer = CreateSection(mc::world::Chunk::Layout::Spanning);
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_15_2);
+        check();
+
+        fill(300);
+        REQUIRE(chunk.GetBitsPerBlock() >= 9);
+        check();
+    }
+}
+
+TEST_CASE("Chunk finds states by palette index", "[Chunk]") {
+    mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
+    registry->RegisterVanillaBlocks(mc::protocol::Version::Minecraft_1_16_5);
+
+    mc::world::ChunkColumnMetadata meta = {};
+    mc::world::Chunk chunk;
+    std::vector<u16> indices;
+
+    auto requireMatches = [&](const std::set<u32>& states, std::size_t begin, std::size_t count) {
+        indices.clear();
+        chunk.FindStateIds(states, begin, count, indices);
+
+        std::vector<u16> expected;
+        for (std::size_t i = begin; i < begin + count; ++i) {
+            if (states.count(chunk.GetStateId(i)))
+                expected.push_back((u16)i);
+        }
+
+        REQUIRE(indices == expected);
+    };
+
+    SECTION("palette sections") {
+        mc::DataBuffer buffer = CreateSection(mc::world::Chunk::Layout::Aligned);
+        chunk.Load(buffer, &meta, 0, mc::protocol::Version::Minecraft_1_16_5);
+
+        requireMatches({ 3 }, 0, 4096);
+        requireMatches({ 0, 31, 500 }, 256, 1024);
+        requireMatches({ 500 }, 0, 4096);
+        REQUIRE(indices.empty());
+    }
+
+    SECTION("global id sections") {
+        for (s32 i = 0; i < 4096; ++i)
+            chunk.SetBlock(mc::Vector3i(i % 16, i / 256, (i / 16) % 16), registry->GetBlock((u32)(i * 7) % 300));
+
+        REQUIRE(chunk.GetBitsPerBlock() >= 9);
+        requireMatches({ 7, 299 }, 0, 4096);
+        requireMatches({ 1 }, 512, 256);
+    }
+
+    SECTION("single value sections") {
+        requireMatches({ 0 }, 256, 256);
+        REQUIRE(indices.size() == 256);
+        requireMatches({ 1 }, 0, 4096);
+        REQUIRE(indices.empty());
+    }
+}
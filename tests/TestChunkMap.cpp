@@ -0,0 +1,83 @@
+#include "catch.hpp"
+
+#include <mclib/world/ChunkMap.h>
+
+#include <map>
+#include <random>
+
+TEST_CASE("ChunkMap stores, replaces and erases columns", "[ChunkMap]") {
+    mc::world::ChunkMap chunks;
+    mc::world::ChunkColumnMetadata meta = {};
+
+    auto first = std::make_shared<mc::world::ChunkColumn>(meta, mc::protocol::Version::Minecraft_1_12_2);
+    auto second = std::make_shared<mc::world::ChunkColumn>(meta, mc::protocol::Version::Minecraft_1_12_2);
+
+    REQUIRE(chunks.Find(0, 0) == nullptr);
+
+    chunks.Insert(-1, 2, first);
+    chunks.Insert(3, -4, nullptr);
+
+    REQUIRE(chunks.GetSize() == 2);
+    REQUIRE(chunks.Find(-1, 2) == first.get());
+    REQUIRE(chunks.Find(2, -1) == nullptr);
+    // Empty columns are stored, but Find can't tell them apart from missing ones.
+    REQUIRE(chunks.Contains(3, -4));
+    REQUIRE(chunks.Find(3, -4) == nullptr);
+
+    chunks.Insert(-1, 2, second);
+    REQUIRE(chunks.GetSize() == 2);
+    REQUIRE(chunks.Find(-1, 2) == second.get());
+
+    REQUIRE(chunks.Erase(-1, 2));
+    REQUIRE_FALSE(chunks.Erase(-1, 2));
+    REQUIRE(chunks.GetSize() == 1);
+    REQUIRE_FALSE(chunks.Contains(-1, 2));
+
+    chunks.Clear();
+    REQUIRE(chunks.IsEmpty());
+    REQUIRE(chunks.begin() == chunks.end());
+}
+
+TEST_CASE("ChunkMap matches std::map under random loads and unloads", "[ChunkMap]") {
+    mc::world::ChunkMap chunks;
+    std::map<std::pair<s32, s32>, mc::world::ChunkColumnPtr> expected;
+    mc::world::ChunkColumnMetadata meta = {};
+
+    std::mt19937 random(20);
+    std::uniform_int_distribution<s32> coord(-12, 12);
+
+    chunks.Reserve(64);
+    std::size_t capacity = chunks.GetCapacity();
+    REQUIRE(capacity >= 128);
+
+    for (int i = 0; i < 5000; ++i) {
+        s32 x = coord(random);
+        s32 z = coord(random);
+
+        if (random() % 3 == 0) {
+            REQUIRE(chunks.Erase(x, z) == (expected.erase(std::make_pair(x, z)) != 0));
+        } else {
+            auto column = std::make_shared<mc::world::ChunkColumn>(meta, mc::protocol::Version::Minecraft_1_12_2);
+            chunks.Insert(x, z, column);
+            expected[std::make_pair(x, z)] = column;
+        }
+
+        REQUIRE(chunks.GetSize() == expected.size());
+    }
+
+    for (s32 x = -12; x <= 12; ++x) {
+        for (s32 z = -12; z <= 12; ++z) {
+            auto iter = expected.find(std::make_pair(x, z));
+            mc::world::ChunkColumn* column = iter == expected.end() ? nullptr : iter->second.get();
+
+            REQUIRE(chunks.Find(x, z) == column);
+        }
+    }
+
+    std::size_t visited = 0;
+    for (const auto& entry : chunks) {
+        REQUIRE(expected[entry.first] == entry.second);
+        ++visited;
+    }
+    REQUIRE(visited == expected.size());
+}
@@ -0,0 +1,40 @@
+#include "catch.hpp"
+
+#include <mclib/common/DataBuffer.h>
+
+#include <vector>
+
+TEST_CASE("DataBuffer reads big endian arrays", "[DataBuffer]") {
+    // Odd counts cover both the vector loop and the scalar tail.
+    const std::size_t Count = 37;
+
+    mc::DataBuffer buffer;
+    buffer << (u8)0xAB;
+
+    for (std::size_t i = 0; i < Count; ++i)
+        buffer << (u64)(0x0102030405060708ULL * (i + 1));
+    for (std::size_t i = 0; i < Count; ++i)
+        buffer << (s32)(-1000 * (s32)i);
+    for (std::size_t i = 0; i < Count; ++i)
+        buffer << (u16)(0x1234 + i);
+
+    u8 marker;
+    buffer >> marker;
+
+    // The arrays start at an odd offset, so the loads are unaligned too.
+    std::vector<u64> longs(Count);
+    std::vector<s32> ints(Count);
+    std::vector<u16> shorts(Count);
+
+    buffer.ReadBigEndianArray(longs.data(), Count);
+    buffer.ReadBigEndianArray(ints.data(), Count);
+    buffer.ReadBigEndianArray(shorts.data(), Count);
+
+    for (std::size_t i = 0; i < Count; ++i) {
+        REQUIRE(longs[i] == 0x0102030405060708ULL * (i + 1));
+        REQUIRE(ints[i] == -1000 * (s32)i);
+        REQUIRE(shorts[i] == (u16)(0x1234 + i));
+    }
+
+    REQUIRE(buffer.IsFinished());
+}
@@ -0,0 +1,40 @@
+#include "catch.hpp"
+
+#include <mclib/common/DataBufferView.h>
+#include <mclib/common/VarInt.h>
+
+#include <stdexcept>
+
+TEST_CASE("DataBufferView reads big endian data in place", "[DataBufferView]") {
+    const u8 data[] = { 0x12, 0x34, 0xAC, 0x02, 0x01, 0xFF };
+    mc::DataBufferView view(data, sizeof(data));
+
+    s16 value;
+    mc::VarInt varint;
+    bool flag;
+
+    view >> value >> varint >> flag;
+
+    REQUIRE(value == 0x1234);
+    REQUIRE(varint.GetInt() == 300);
+    REQUIRE(flag);
+    REQUIRE(view.GetRemaining() == 1);
+    REQUIRE(view.GetReadPointer() == &data[5]);
+}
+
+TEST_CASE("DataBufferView throws when reading past the end", "[DataBufferView]") {
+    const u8 data[] = { 0x01, 0x02, 0x80 };
+    mc::DataBufferView view(data, sizeof(data));
+
+    s32 value;
+    REQUIRE_THROWS_AS(view >> value, std::out_of_range);
+    REQUIRE(view.GetReadOffset() == 0);
+
+    mc::DataBufferView sub;
+    view.ReadSome(sub, 2);
+    REQUIRE(sub.GetSize() == 2);
+    REQUIRE(sub.GetData() == &data[0]);
+
+    mc::VarInt varint;
+    REQUIRE_THROWS_AS(view >> varint, std::out_of_range);
+}
@@ -0,0 +1,154 @@
+#include "catch.hpp"
+#include "WorldHelpers.h"
+
+#include <mclib/world/Heightmap.h>
+
+#include <memory>
+#include <vector>
+
+using helpers::Stone;
+
+namespace {
+
+s32 GetExpectedHeight(s32 x, s32 z) {
+    return (x * 3 + z * 5) % 40;
+}
+
+// Packs the expected heights seven to a long, or spanning across longs like 1.14 and 1.15.
+std::vector<s64> CreateHeights(bool aligned) {
+    std::vector<s64> data(aligned ? mc::world::Heightmap::LongCount : 36, 0);
+
+    for (s32 i = 0; i < 256; ++i) {
+        const u64 height = (u64)GetExpectedHeight(i & 15, i >> 4);
+
+        if (aligned) {
+            data[i / 7] |= (s64)(height << ((i % 7) * 9));
+        } else {
+            const std::size_t bit = (std::size_t)i * 9;
+
+            data[bit / 64] |= (s64)(height << (bit % 64));
+            if (bit % 64 + 9 > 64)
+                data[bit / 64 + 1] |= (s64)(height >> (64 - bit % 64));
+        }
+    }
+
+    return data;
+}
+
+// A column at 0, 0 where each x, z is filled with stone up to GetExpectedHeight.
+helpers::ColumnData CreateColumn() {
+    return helpers::ColumnData(0, 0, (1 << 0) | (1 << 1) | (1 << 2), [](s32 x, s32 y, s32 z) {
+        return y < GetExpectedHeight(x, z) ? Stone : 0;
+    });
+}
+
+} // ns
+
+TEST_CASE("Heightmap loads aligned and spanning long arrays", "[Heightmap]") {
+    for (bool aligned : { true, false }) {
+        mc::world::Heightmap heightmap;
+
+        REQUIRE(heightmap.Load(CreateHeights(aligned), aligned));
+
+        for (s32 z = 0; z < 16; ++z)
+            for (s32 x = 0; x < 16; ++x)
+                REQUIRE(heightmap.Get(x, z) == GetExpectedHeight(x, z));
+    }
+
+    mc::world::Heightmap heightmap;
+    heightmap.Set(3, 4, 256);
+
+    REQUIRE(heightmap.Get(3, 4) == 256);
+    REQUIRE(heightmap.Get(4, 4) == 0);
+    REQUIRE_FALSE(heightmap.Load(std::vector<s64>(10, -1), true));
+    REQUIRE(heightmap.Get(3, 4) == 256);
+}
+
+TEST_CASE("ChunkDataPacket reads the sent heightmaps", "[Heightmap]") {
+    mc::nbt::TagCompound heightmaps(L"");
+    heightmaps.AddItem(mc::nbt::TagType::LongArray, std::make_shared<mc::nbt::TagLongArray>(L"MOTION_BLOCKING", CreateHeights(true)));
+    heightmaps.AddItem(mc::nbt::TagType::LongArray, std::make_shared<mc::nbt::TagLongArray>(L"WORLD_SURFACE", std::vector<s64>(mc::world::Heightmap::LongCount, 0)));
+
+    helpers::ColumnData data(0, 0, 0, [](s32, s32, s32) { return 0u; });
+    data.heightmaps.SetRoot(heightmaps);
+
+    mc::protocol::packets::in::ChunkDataPacket packet;
+    helpers::ReadChunkData(data, mc::protocol::Version::Minecraft_1_16_5, packet);
+
+    const mc::world::ChunkColumn& column = *packet.GetChunkColumn();
+
+    for (s32 z = 0; z < 16; ++z) {
+        for (s32 x = 0; x < 16; ++x) {
+            REQUIRE(column.GetHeightmap(mc::world::Heightmap::Type::MotionBlocking).Get(x, z) == GetExpectedHeight(x, z));
+            REQUIRE(column.GetHeightmap(mc::world::Heightmap::Type::WorldSurface).Get(x, z) == 0);
+        }
+    }
+}
+
+TEST_CASE("World computes and updates heightmaps", "[Heightmap]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    fixture.LoadColumn(CreateColumn());
+
+    for (s32 z = 0; z < 16; ++z) {
+        for (s32 x = 0; x < 16; ++x) {
+            REQUIRE(world.GetHeight(x, z) == GetExpectedHeight(x, z));
+            REQUIRE(world.GetHeight(x, z, mc::world::Heightmap::Type::WorldSurface) == GetExpectedHeight(x, z));
+        }
+    }
+
+    REQUIRE(world.GetHeight(16, 0) == 0);
+
+    // Placing above the top raises the height, placing below it doesn't change it.
+    REQUIRE(GetExpectedHeight(2, 3) == 21);
+    fixture.ChangeBlock(mc::Vector3i(2, 100, 3), Stone);
+    REQUIRE(world.GetHeight(2, 3) == 101);
+    fixture.ChangeBlock(mc::Vector3i(2, 60, 3), Stone);
+    REQUIRE(world.GetHeight(2, 3) == 101);
+
+    // Removing the top block falls back to the next block below it, across empty sections.
+    fixture.ChangeBlock(mc::Vector3i(2, 100, 3), 0);
+    REQUIRE(world.GetHeight(2, 3) == 61);
+    fixture.ChangeBlock(mc::Vector3i(2, 60, 3), 0);
+    REQUIRE(world.GetHeight(2, 3) == 21);
+    fixture.ChangeBlock(mc::Vector3i(2, 20, 3), 0);
+    REQUIRE(world.GetHeight(2, 3) == 20);
+
+    // Clearing a whole column leaves nothing.
+    REQUIRE(GetExpectedHeight(0, 0) == 0);
+    fixture.ChangeBlock(mc::Vector3i(0, 0, 0), Stone);
+    REQUIRE(world.GetHeight(0, 0, mc::world::Heightmap::Type::WorldSurface) == 1);
+    fixture.ChangeBlock(mc::Vector3i(0, 0, 0), 0);
+    REQUIRE(world.GetHeight(0, 0, mc::world::Heightmap::Type::WorldSurface) == 0);
+}
+
+TEST_CASE("MOTION_BLOCKING heightmaps count fluids", "[Heightmap]") {
+    helpers::WorldFixture fixture(mc::protocol::Version::Minecraft_1_16_5);
+    mc::world::World& world = fixture.world;
+    const mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
+    // 1.16.5 state ids
+    const u32 Stone116 = 1;
+    const u32 Water = 34;
+
+    // The flattened tables don't count water as solid.
+    REQUIRE_FALSE(registry->IsSolid(Water));
+    REQUIRE(registry->IsMotionBlocking(Water));
+    REQUIRE(registry->IsMotionBlocking(Stone116));
+    REQUIRE_FALSE(registry->IsMotionBlocking(0));
+
+    // Stone up to y 10 with water over it up to y 20.
+    fixture.LoadColumn(helpers::ColumnData(0, 0, (1 << 0) | (1 << 1), [](s32 x, s32 y, s32 z) {
+        return y < 10 ? Stone116 : (y < 20 ? Water : 0u);
+    }));
+
+    REQUIRE(world.GetHeight(5, 5) == 20);
+    REQUIRE(world.GetHeight(5, 5, mc::world::Heightmap::Type::WorldSurface) == 20);
+
+    // Removing the surface of the water only lowers the height by one.
+    fixture.ChangeBlock(mc::Vector3i(5, 19, 5), 0);
+    REQUIRE(world.GetHeight(5, 5) == 19);
+
+    fixture.ChangeBlock(mc::Vector3i(5, 30, 5), Water);
+    REQUIRE(world.GetHeight(5, 5) == 31);
+}
@@ -0,0 +1,164 @@
+#include "catch.hpp"
+#include "WorldHelpers.h"
+
+#include <mclib/common/VarInt.h>
+#include <mclib/world/Light.h>
+
+#include <vector>
+
+namespace {
+
+u8 GetExpectedLight(s32 x, s32 y, s32 z) {
+    return (u8)((x + y * 3 + z * 5) & 15);
+}
+
+std::vector<u8> CreateLight() {
+    std::vector<u8> bytes(mc::world::NibbleArray::Size, 0);
+
+    for (s32 i = 0; i < 4096; ++i)
+        bytes[i / 2] |= GetExpectedLight(i & 15, i >> 8, (i >> 4) & 15) << ((i & 1) * 4);
+
+    return bytes;
+}
+
+// Sends block light for section 0 of a column in the 1.16.5 format.
+void SendBlockLight(mc::world::World& world, s32 chunkX) {
+    std::vector<u8> bytes = CreateLight();
+
+    mc::DataBuffer buffer;
+    buffer << mc::VarInt(chunkX) << mc::VarInt(0) << true;
+    buffer << mc::VarInt(0) << mc::VarInt(1 << 1) << mc::VarInt(0) << mc::VarInt(0);
+    buffer << mc::VarInt(mc::world::NibbleArray::Size);
+    for (u8 value : bytes)
+        buffer << value;
+
+    mc::protocol::packets::in::UpdateLightPacket packet;
+    packet.SetProtocolVersion(mc::protocol::Version::Minecraft_1_16_5);
+    REQUIRE(packet.Deserialize(buffer, buffer.GetSize()));
+    world.HandlePacket(&packet);
+}
+
+} // ns
+
+TEST_CASE("NibbleArray reads packed light levels", "[Light]") {
+    std::vector<u8> bytes = CreateLight();
+    mc::world::NibbleArray light(bytes.data());
+
+    REQUIRE_FALSE(light.IsUniform());
+
+    for (s32 y = 0; y < 16; ++y)
+        for (s32 z = 0; z < 16; ++z)
+            for (s32 x = 0; x < 16; ++x)
+                REQUIRE(light.Get(x, y, z) == GetExpectedLight(x, y, z));
+
+    std::vector<u8> bright(mc::world::NibbleArray::Size, 0xEE);
+    mc::world::NibbleArray uniform(bright.data());
+
+    REQUIRE(uniform.IsUniform());
+    REQUIRE(uniform.Get(4095) == 14);
+    // Uniform arrays share their storage.
+    REQUIRE(&uniform.GetBytes() == &mc::world::NibbleArray((u8)14).GetBytes());
+    REQUIRE(mc::world::NibbleArray().Get(0) == 0);
+}
+
+TEST_CASE("UpdateLightPacket reads the light masks", "[Light]") {
+    std::vector<u8> bytes = CreateLight();
+
+    mc::DataBuffer buffer;
+    // Sky light for section 0, empty sky light for section 1 and block light for section -1.
+    buffer << mc::VarInt(3) << mc::VarInt(-2) << true;
+    buffer << mc::VarInt(1 << 1) << mc::VarInt(1 << 0) << mc::VarInt(1 << 2) << mc::VarInt(0);
+    buffer << mc::VarInt(mc::world::NibbleArray::Size);
+    for (u8 value : bytes)
+        buffer << value;
+    buffer << mc::VarInt(mc::world::NibbleArray::Size);
+    for (s32 i = 0; i < mc::world::NibbleArray::Size; ++i)
+        buffer << (u8)0x77;
+
+    mc::protocol::packets::in::UpdateLightPacket packet;
+    packet.SetProtocolVersion(mc::protocol::Version::Minecraft_1_16_5);
+    REQUIRE(packet.Deserialize(buffer, buffer.GetSize()));
+    REQUIRE(buffer.IsFinished());
+
+    REQUIRE(packet.GetChunkX() == 3);
+    REQUIRE(packet.GetChunkZ() == -2);
+    REQUIRE(packet.GetTrustEdges());
+    REQUIRE(packet.GetSkyLight().size() == 2);
+    REQUIRE(packet.GetBlockLight().size() == 1);
+
+    mc::world::ColumnLight light(true);
+    packet.Apply(light);
+
+    REQUIRE(light.GetSkyLight(5, 7, 9) == GetExpectedLight(5, 7, 9));
+    REQUIRE(light.GetSkyLight(5, 20, 9) == 0);
+    REQUIRE(light.GetSkyLight(5, 40, 9) == 15);
+    REQUIRE(light.GetBlockLight(0, -1, 0) == 7);
+    REQUIRE(light.GetBlockLight(0, 0, 0) == 0);
+    REQUIRE(light.GetBlockLight(0, 300, 0) == 0);
+}
+
+TEST_CASE("World keeps the light of loaded columns", "[Light]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    // Light for column 1 arrives before its chunk data.
+    mc::DataBuffer buffer;
+    buffer << mc::VarInt(1) << mc::VarInt(0);
+    buffer << mc::VarInt(0) << mc::VarInt(0) << mc::VarInt(0) << mc::VarInt(1 << 1);
+
+    mc::protocol::packets::in::UpdateLightPacket update;
+    update.SetProtocolVersion(mc::protocol::Version::Minecraft_1_15_2);
+    REQUIRE(update.Deserialize(buffer, buffer.GetSize()));
+    world.HandlePacket(&update);
+
+    // Both columns send block light in their air section 0, column 1 has it replaced by the pending light.
+    for (s32 chunkX = 0; chunkX < 2; ++chunkX) {
+        helpers::ColumnData column(chunkX, 0, 1 << 0, [](s32, s32, s32) { return 0u; });
+        column.blockLight = GetExpectedLight;
+
+        fixture.LoadColumn(column);
+    }
+
+    for (s32 y = 0; y < 16; ++y) {
+        for (s32 z = 0; z < 16; ++z) {
+            for (s32 x = 0; x < 16; ++x) {
+                REQUIRE(world.GetBlockLight(mc::Vector3i(x, y, z)) == GetExpectedLight(x, y, z));
+                REQUIRE(world.GetSkyLight(mc::Vector3i(x, y, z)) == 15);
+                REQUIRE(world.GetBlockLight(mc::Vector3i(16 + x, y, z)) == 0);
+            }
+        }
+    }
+
+    // Unloaded columns are dark.
+    REQUIRE(world.GetSkyLight(mc::Vector3i(-1, 0, 0)) == 0);
+}
+
+TEST_CASE("World keeps light sent before a column is reloaded", "[Light]") {
+    helpers::WorldFixture fixture(mc::protocol::Version::Minecraft_1_16_5);
+    mc::world::World& world = fixture.world;
+    auto air = [](s32, s32, s32) { return 0u; };
+
+    fixture.LoadColumn(helpers::ColumnData(0, 0, 1 << 0, air));
+
+    // The server sends the light of a loaded column again right before resending its chunk data.
+    SendBlockLight(world, 0);
+    fixture.LoadColumn(helpers::ColumnData(0, 0, 1 << 0, air));
+
+    REQUIRE(world.GetBlockLight(mc::Vector3i(3, 4, 5)) == GetExpectedLight(3, 4, 5));
+    REQUIRE(world.GetBlockLight(mc::Vector3i(15, 15, 15)) == GetExpectedLight(15, 15, 15));
+
+    // Light for a column that is unloaded before its chunk data arrives is dropped.
+    SendBlockLight(world, 1);
+
+    mc::DataBuffer buffer;
+    buffer << (s32)1 << (s32)0;
+
+    mc::protocol::packets::in::UnloadChunkPacket unload;
+    unload.SetProtocolVersion(mc::protocol::Version::Minecraft_1_16_5);
+    REQUIRE(unload.Deserialize(buffer, buffer.GetSize()));
+    world.HandlePacket(&unload);
+
+    fixture.LoadColumn(helpers::ColumnData(1, 0, 1 << 0, air));
+
+    REQUIRE(world.GetBlockLight(mc::Vector3i(16 + 3, 4, 5)) == 0);
+}
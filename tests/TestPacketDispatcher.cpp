@@ -0,0 +1,216 @@
+#include "catch.hpp"
+
+#include <mclib/common/DataBuffer.h>
+#include <mclib/common/DataBufferView.h>
+#include <mclib/common/VarInt.h>
+#include <mclib/core/Connection.h>
+#include <mclib/protocol/packets/PacketDispatcher.h>
+#include <mclib/protocol/packets/PacketFactory.h>
+#include <mclib/protocol/packets/PacketHandler.h>
+
+#include <functional>
+#include <stdexcept>
+
+using mc::protocol::Protocol;
+using mc::protocol::State;
+using mc::protocol::packets::PacketDispatcher;
+using mc::protocol::packets::PacketFactory;
+namespace in = mc::protocol::packets::in;
+
+namespace {
+
+// 1.12.2 protocol ids
+const s32 ChangeGameStateId = 0x1E;
+const s32 KeepAliveId = 0x1F;
+
+class ChangeGameStateHandler : public mc::protocol::packets::PacketHandler {
+public:
+    explicit ChangeGameStateHandler(PacketDispatcher* dispatcher) : PacketHandler(dispatcher) { }
+
+    void HandlePacket(in::ChangeGameStatePacket* packet) override { }
+};
+
+// Counts the keep alive packets it gets and runs an action on each one.
+class KeepAliveHandler : public mc::protocol::packets::PacketHandler {
+public:
+    std::size_t count = 0;
+    std::function<void()> action;
+
+    explicit KeepAliveHandler(PacketDispatcher* dispatcher) : PacketHandler(dispatcher) { }
+
+    void HandlePacket(in::KeepAlivePacket* packet) override {
+        ++count;
+        if (action) action();
+    }
+};
+
+// A keep alive packet built by hand, so it only has its protocol id.
+in::KeepAlivePacket CreateKeepAlive() {
+    in::KeepAlivePacket packet;
+
+    packet.SetId(KeepAliveId);
+    packet.SetProtocolVersion(mc::protocol::Version::Minecraft_1_12_2);
+    return packet;
+}
+
+} // ns
+
+TEST_CASE("PacketFactory only decodes packets that something handles", "[PacketDispatcher]") {
+    PacketDispatcher dispatcher;
+    mc::core::Connection connection(&dispatcher, mc::protocol::Version::Minecraft_1_12_2);
+    Protocol& protocol = Protocol::GetProtocol(mc::protocol::Version::Minecraft_1_12_2);
+    const s32 agnosticId = mc::protocol::play::ChangeGameState;
+
+    mc::DataBuffer buffer;
+    buffer << mc::VarInt(ChangeGameStateId) << (u8)7 << 0.5f;
+
+    auto create = [&](mc::protocol::packets::Packet*& packet) {
+        return PacketFactory::TryCreatePacket(protocol, State::Play, mc::DataBufferView(buffer), buffer.GetSize(), &connection, packet);
+    };
+
+    mc::protocol::packets::Packet* packet = nullptr;
+
+    REQUIRE_FALSE(dispatcher.ShouldDecode(State::Play, agnosticId));
+    REQUIRE(create(packet) == mc::DecodeResult::Skipped);
+    REQUIRE(packet == nullptr);
+
+    SECTION("registered handlers") {
+        ChangeGameStateHandler handler(&dispatcher);
+        dispatcher.RegisterHandler(State::Play, agnosticId, &handler);
+
+        REQUIRE(dispatcher.ShouldDecode(State::Play, agnosticId));
+        REQUIRE(create(packet) == mc::DecodeResult::Success);
+        REQUIRE(dynamic_cast<in::ChangeGameStatePacket*>(packet)->GetValue() == 0.5f);
+        PacketFactory::FreePacket(packet);
+
+        dispatcher.UnregisterHandler(&handler);
+        REQUIRE(create(packet) == mc::DecodeResult::Skipped);
+    }
+
+    SECTION("always decoded types") {
+        dispatcher.SetAlwaysDecode(State::Play, agnosticId);
+
+        REQUIRE_FALSE(dispatcher.HasHandlers(State::Play, agnosticId));
+        REQUIRE(dispatcher.ShouldDecode(State::Play, agnosticId));
+        REQUIRE(create(packet) == mc::DecodeResult::Success);
+        REQUIRE(dynamic_cast<in::ChangeGameStatePacket*>(packet)->GetValue() == 0.5f);
+        PacketFactory::FreePacket(packet);
+
+        dispatcher.SetAlwaysDecode(State::Play, agnosticId, false);
+        REQUIRE(create(packet) == mc::DecodeResult::Skipped);
+    }
+}
+
+TEST_CASE("PacketDispatcher table only covers registered ids", "[PacketDispatcher]") {
+    PacketDispatcher dispatcher;
+    KeepAliveHandler low(&dispatcher);
+    KeepAliveHandler high(&dispatcher);
+    const s32 lowId = mc::protocol::play::KeepAlive;
+    const s32 highId = lowId + 40;
+
+    REQUIRE(dispatcher.GetTableSize(State::Play) == 0);
+
+    dispatcher.RegisterHandler(State::Play, lowId, &low);
+    REQUIRE(dispatcher.GetTableSize(State::Play) == lowId + 1);
+
+    dispatcher.RegisterHandler(State::Play, highId, &high);
+    REQUIRE(dispatcher.GetTableSize(State::Play) == highId + 1);
+    REQUIRE(dispatcher.HasHandlers(State::Play, lowId));
+    REQUIRE(dispatcher.HasHandlers(State::Play, highId));
+    REQUIRE_FALSE(dispatcher.HasHandlers(State::Play, highId - 1));
+    REQUIRE_FALSE(dispatcher.HasHandlers(State::Play, highId + 1));
+    REQUIRE(dispatcher.GetTableSize(State::Login) == 0);
+
+    SECTION("unregistering the last id shrinks the table") {
+        dispatcher.UnregisterHandler(State::Play, highId, &high);
+
+        REQUIRE(dispatcher.GetTableSize(State::Play) == lowId + 1);
+        REQUIRE_FALSE(dispatcher.HasHandlers(State::Play, highId));
+    }
+
+    SECTION("unregistering a handler from every id") {
+        dispatcher.RegisterHandler(State::Play, highId, &low);
+        dispatcher.UnregisterHandler(&low);
+
+        REQUIRE(dispatcher.GetTableSize(State::Play) == highId + 1);
+        REQUIRE_FALSE(dispatcher.HasHandlers(State::Play, lowId));
+
+        dispatcher.UnregisterHandler(&high);
+        REQUIRE(dispatcher.GetTableSize(State::Play) == 0);
+    }
+
+    SECTION("always decoded types keep their entry") {
+        dispatcher.UnregisterHandler(&low);
+        dispatcher.SetAlwaysDecode(State::Play, highId + 10);
+        dispatcher.UnregisterHandler(&high);
+
+        REQUIRE(dispatcher.GetTableSize(State::Play) == highId + 11);
+
+        dispatcher.SetAlwaysDecode(State::Play, highId + 10, false);
+        REQUIRE(dispatcher.GetTableSize(State::Play) == 0);
+    }
+
+    SECTION("ids without an entry") {
+        // Nothing to unregister past the end of the table.
+        dispatcher.UnregisterHandler(State::Play, highId + 100, &high);
+        dispatcher.SetAlwaysDecode(State::Play, highId + 100, false);
+
+        REQUIRE(dispatcher.GetTableSize(State::Play) == highId + 1);
+        REQUIRE_THROWS_AS(dispatcher.RegisterHandler(State::Play, -1, &high), std::out_of_range);
+    }
+}
+
+TEST_CASE("PacketDispatcher looks up the agnostic id of packets without one", "[PacketDispatcher]") {
+    PacketDispatcher dispatcher;
+    KeepAliveHandler handler(&dispatcher);
+
+    dispatcher.RegisterHandler(State::Play, mc::protocol::play::KeepAlive, &handler);
+
+    in::KeepAlivePacket packet = CreateKeepAlive();
+    REQUIRE(packet.GetAgnosticId() < 0);
+
+    dispatcher.Dispatch(&packet);
+    REQUIRE(handler.count == 1);
+
+    // Packets from the protocol skip the lookup.
+    packet.SetAgnosticId(mc::protocol::play::KeepAlive);
+    dispatcher.Dispatch(&packet);
+    REQUIRE(handler.count == 2);
+}
+
+TEST_CASE("PacketDispatcher handlers can change the handlers being dispatched to", "[PacketDispatcher]") {
+    PacketDispatcher dispatcher;
+    KeepAliveHandler first(&dispatcher);
+    KeepAliveHandler second(&dispatcher);
+    KeepAliveHandler added(&dispatcher);
+    const s32 agnosticId = mc::protocol::play::KeepAlive;
+
+    dispatcher.RegisterHandler(State::Play, agnosticId, &first);
+    dispatcher.RegisterHandler(State::Play, agnosticId, &second);
+
+    first.action = [&]() {
+        dispatcher.UnregisterHandler(&second);
+        dispatcher.RegisterHandler(State::Play, agnosticId, &added);
+    };
+
+    in::KeepAlivePacket packet = CreateKeepAlive();
+    dispatcher.Dispatch(&packet);
+
+    // The unregistered handler is skipped and the new one runs in the same dispatch.
+    REQUIRE(first.count == 1);
+    REQUIRE(second.count == 0);
+    REQUIRE(added.count == 1);
+
+    SECTION("unregistering every handler of the type") {
+        first.action = [&]() {
+            dispatcher.UnregisterHandler(State::Play, agnosticId, &first);
+            dispatcher.UnregisterHandler(State::Play, agnosticId, &added);
+        };
+
+        dispatcher.Dispatch(&packet);
+
+        REQUIRE(first.count == 2);
+        REQUIRE(added.count == 1);
+        REQUIRE(dispatcher.GetTableSize(State::Play) == 0);
+    }
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+
+#include <mclib/common/DataBuffer.h>
+#include <mclib/common/DataBufferView.h>
+#include <mclib/common/VarInt.h>
+#include <mclib/protocol/packets/PacketFactory.h>
+
+#include <vector>
+
+using mc::protocol::Protocol;
+using mc::protocol::State;
+using mc::protocol::packets::PacketFactory;
+namespace in = mc::protocol::packets::in;
+
+namespace {
+
+// Returns the protocol id of an inbound play packet.
+s32 GetProtocolId(const Protocol& protocol, s32 agnosticId) {
+    for (s32 id = 0; id < 0x80; ++id) {
+        s32 agnostic = 0;
+
+        if (protocol.GetAgnosticId(State::Play, id, agnostic) && agnostic == agnosticId)
+            return id;
+    }
+
+    FAIL("The protocol doesn't have the packet.");
+    return -1;
+}
+
+mc::protocol::packets::Packet* CreateMultiBlockChange(Protocol& protocol, s32 changes) {
+    mc::DataBuffer buffer;
+    buffer << mc::VarInt(GetProtocolId(protocol, mc::protocol::play::MultiBlockChange));
+    buffer << (s32)2 << (s32)-3 << mc::VarInt(changes);
+    for (s32 i = 0; i < changes; ++i)
+        buffer << (u8)i << (u8)64 << mc::VarInt(1 << 4);
+
+    return PacketFactory::CreatePacket(protocol, State::Play, mc::DataBufferView(buffer), buffer.GetSize());
+}
+
+} // ns
+
+TEST_CASE("PacketFactory reuses freed packets", "[PacketFactory]") {
+    Protocol& protocol = Protocol::GetProtocol(mc::protocol::Version::Minecraft_1_12_2);
+    const s32 agnosticId = mc::protocol::play::MultiBlockChange;
+
+    mc::protocol::packets::Packet* first = CreateMultiBlockChange(protocol, 3);
+    REQUIRE(dynamic_cast<in::MultiBlockChangePacket*>(first)->GetBlockChanges().size() == 3);
+
+    const std::size_t freeCount = PacketFactory::GetFreeCount(State::Play, agnosticId);
+    PacketFactory::FreePacket(first);
+    REQUIRE(PacketFactory::GetFreeCount(State::Play, agnosticId) == freeCount + 1);
+
+    // The next packet of the same type is the freed one, reset before it's deserialized again.
+    mc::protocol::packets::Packet* second = CreateMultiBlockChange(protocol, 1);
+    REQUIRE(second == first);
+    REQUIRE(PacketFactory::GetFreeCount(State::Play, agnosticId) == freeCount);
+
+    auto changes = dynamic_cast<in::MultiBlockChangePacket*>(second)->GetBlockChanges();
+    REQUIRE(changes.size() == 1);
+    REQUIRE(changes[0].y == 64);
+
+    PacketFactory::FreePacket(second);
+}
+
+TEST_CASE("PacketFactory deletes packets it doesn't pool", "[PacketFactory]") {
+    Protocol& protocol = Protocol::GetProtocol(mc::protocol::Version::Minecraft_1_12_2);
+
+    SECTION("packets that don't opt in") {
+        const s32 agnosticId = mc::protocol::play::ChangeGameState;
+
+        mc::DataBuffer buffer;
+        buffer << mc::VarInt(GetProtocolId(protocol, agnosticId)) << (u8)7 << 1.0f;
+
+        mc::protocol::packets::Packet* packet = PacketFactory::CreatePacket(protocol, State::Play, mc::DataBufferView(buffer), buffer.GetSize());
+        REQUIRE(dynamic_cast<in::ChangeGameStatePacket*>(packet) != nullptr);
+
+        PacketFactory::FreePacket(packet);
+        REQUIRE(PacketFactory::GetFreeCount(State::Play, agnosticId) == 0);
+    }
+
+    SECTION("packets past the limit of each type") {
+        const s32 agnosticId = mc::protocol::play::MultiBlockChange;
+        std::vector<mc::protocol::packets::Packet*> packets;
+
+        for (s32 i = 0; i < 40; ++i)
+            packets.push_back(CreateMultiBlockChange(protocol, 1));
+
+        REQUIRE(PacketFactory::GetFreeCount(State::Play, agnosticId) == 0);
+
+        for (mc::protocol::packets::Packet* packet : packets)
+            PacketFactory::FreePacket(packet);
+
+        REQUIRE(PacketFactory::GetFreeCount(State::Play, agnosticId) == 32);
+    }
+}
@@ -0,0 +1,40 @@
+#include "catch.hpp"
+
+#include <mclib/protocol/Protocol.h>
+
+using mc::protocol::Protocol;
+using mc::protocol::Version;
+namespace out = mc::protocol::packets::out;
+
+TEST_CASE("Protocol resolves outbound ids per version", "[Protocol]") {
+    const Protocol& legacy = Protocol::GetProtocol(Version::Minecraft_1_11_2);
+    const Protocol& latest = Protocol::GetProtocol(Version::Minecraft_1_16_5);
+
+    REQUIRE(legacy.GetPacketId<out::ChatPacket>() == 0x02);
+    REQUIRE(latest.GetPacketId<out::ChatPacket>() == 0x03);
+
+    out::KeepAlivePacket keepAlive(0);
+    REQUIRE(latest.GetPacketId(keepAlive) == 0x10);
+}
+
+TEST_CASE("Protocol rejects packets the version doesn't have", "[Protocol]") {
+    const Protocol& legacy = Protocol::GetProtocol(Version::Minecraft_1_11_2);
+    const Protocol& latest = Protocol::GetProtocol(Version::Minecraft_1_16_5);
+
+    REQUIRE_THROWS_AS(legacy.GetPacketId<out::LoginPluginResponsePacket>(), mc::protocol::UnsupportedPacketException);
+    REQUIRE_THROWS_AS(latest.GetPacketId<out::PrepareCraftingGridPacket>(), mc::protocol::UnsupportedPacketException);
+}
+
+TEST_CASE("Protocol creates inbound packets from protocol ids", "[Protocol]") {
+    Protocol& latest = Protocol::GetProtocol(Version::Minecraft_1_16_5);
+
+    mc::protocol::packets::InboundPacket* packet = latest.CreateInboundPacket(mc::protocol::State::Play, 0x1F);
+
+    REQUIRE(packet != nullptr);
+    REQUIRE(packet->GetId().GetInt() == 0x1F);
+    REQUIRE(packet->GetAgnosticId() == mc::protocol::play::KeepAlive);
+    delete packet;
+
+    REQUIRE(latest.CreateInboundPacket(mc::protocol::State::Play, 0x7F) == nullptr);
+    REQUIRE(latest.CreateInboundPacket(mc::protocol::State::Play, -1) == nullptr);
+}
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include <mclib/network/Network.h>
+#include <mclib/network/Reactor.h>
+
+#include <cstring>
+
+using mc::network::Reactor;
+using mc::network::SocketHandle;
+
+namespace {
+
+// Two ends of a TCP connection over loopback.
+class SocketPair {
+public:
+    SocketHandle client;
+    SocketHandle server;
+
+    SocketPair() : client(INVALID_SOCKET), server(INVALID_SOCKET) {
+        SocketHandle listener = (SocketHandle)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        REQUIRE(listener != INVALID_SOCKET);
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        socklen_t length = sizeof(address);
+        REQUIRE(bind(listener, (sockaddr*)&address, sizeof(address)) == 0);
+        REQUIRE(listen(listener, 1) == 0);
+        REQUIRE(getsockname(listener, (sockaddr*)&address, &length) == 0);
+
+        client = (SocketHandle)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        REQUIRE(connect(client, (sockaddr*)&address, sizeof(address)) == 0);
+        server = (SocketHandle)accept(listener, nullptr, nullptr);
+        REQUIRE(server != INVALID_SOCKET);
+
+        closesocket(listener);
+    }
+
+    ~SocketPair() {
+        closesocket(client);
+        closesocket(server);
+    }
+
+    void Send(SocketHandle handle) {
+        const char data = 1;
+        REQUIRE(send(handle, &data, 1, 0) == 1);
+    }
+};
+
+class CountingHandler : public mc::network::ReactorHandler {
+public:
+    std::size_t readable = 0;
+    std::size_t writable = 0;
+
+    void OnReadable() override { ++readable; }
+    void OnWritable() override { ++writable; }
+};
+
+class PollListener : public mc::network::ReactorListener {
+public:
+    std::size_t polls = 0;
+
+    void OnPoll() override { ++polls; }
+};
+
+} // ns
+
+TEST_CASE("Reactor wakes handlers of ready sockets", "[Reactor]") {
+    SocketPair sockets;
+    Reactor reactor;
+    CountingHandler handler;
+    PollListener listener;
+
+    reactor.RegisterListener(&listener);
+
+    REQUIRE(reactor.Register(sockets.server, &handler));
+    REQUIRE(reactor.GetSize() == 1);
+    REQUIRE_FALSE(reactor.Register(INVALID_SOCKET, &handler));
+
+    // Nothing was sent yet.
+    REQUIRE(reactor.Poll(0) == 0);
+    REQUIRE(handler.readable == 0);
+    REQUIRE(listener.polls == 1);
+
+    sockets.Send(sockets.client);
+    REQUIRE(reactor.Poll(1000) == 1);
+    REQUIRE(handler.readable == 1);
+    REQUIRE(handler.writable == 0);
+
+    SECTION("writable events") {
+        REQUIRE(reactor.Modify(sockets.server, Reactor::Writable));
+        REQUIRE(reactor.Poll(1000) == 1);
+        REQUIRE(handler.writable == 1);
+        REQUIRE(handler.readable == 1);
+    }
+
+    SECTION("unregistered sockets") {
+        reactor.Unregister(sockets.server);
+        REQUIRE(reactor.GetSize() == 0);
+        REQUIRE_FALSE(reactor.Modify(sockets.server, Reactor::Writable));
+
+        sockets.Send(sockets.client);
+        REQUIRE(reactor.Poll(0) == 0);
+        REQUIRE(handler.readable == 1);
+    }
+
+    reactor.UnregisterListener(&listener);
+}
@@ -0,0 +1,54 @@
+#include "catch.hpp"
+
+#include <mclib/network/StreamBuffer.h>
+
+#include <cstring>
+
+TEST_CASE("StreamBuffer queues and consumes data in order", "[StreamBuffer]") {
+    mc::network::StreamBuffer buffer;
+    const u8 first[] = { 1, 2, 3, 4 };
+    const u8 second[] = { 5, 6 };
+
+    buffer.Write(first, sizeof(first));
+    buffer.Write(second, sizeof(second));
+
+    REQUIRE(buffer.GetSize() == 6);
+    REQUIRE(buffer.GetReadPointer()[0] == 1);
+
+    buffer.Consume(3);
+
+    REQUIRE(buffer.GetSize() == 3);
+    REQUIRE(buffer.GetReadPointer()[0] == 4);
+    REQUIRE(buffer.GetReadPointer()[2] == 6);
+
+    buffer.Consume(3);
+
+    REQUIRE(buffer.IsEmpty());
+}
+
+TEST_CASE("StreamBuffer keeps unread data when making room", "[StreamBuffer]") {
+    mc::network::StreamBuffer buffer(8);
+    const u8 data[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    buffer.Write(data, sizeof(data));
+    buffer.Consume(6);
+
+    SECTION("writing past the end moves the unread tail") {
+        u8* out = buffer.PrepareWrite(4);
+        memset(out, 9, 4);
+        buffer.CommitWrite(4);
+
+        REQUIRE(buffer.GetSize() == 6);
+        REQUIRE(buffer.GetReadPointer()[0] == 7);
+        REQUIRE(buffer.GetReadPointer()[1] == 8);
+        REQUIRE(buffer.GetReadPointer()[5] == 9);
+    }
+
+    SECTION("reserving grows the buffer for a whole frame") {
+        buffer.Reserve(64);
+
+        REQUIRE(buffer.GetSize() == 2);
+        REQUIRE(buffer.GetWritable() >= 62);
+        REQUIRE(buffer.GetReadPointer()[0] == 7);
+    }
+}
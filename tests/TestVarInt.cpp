@@ -4,6 +4,12 @@
 #include <mclib/common/DataBuffer.h>
 
 #include <limits>
+#include <string>
+#include <vector>
+
+static_assert(mc::VarInt::GetSerializedLength(0) == 1, "VarInt length must be usable at compile time.");
+static_assert(mc::VarInt::GetSerializedLength(300) == 2, "VarInt length must be usable at compile time.");
+static_assert(mc::VarInt::GetSerializedLength(-1) == 10, "VarInt length must be usable at compile time.");
 
 TEST_CASE("VarInt stores and returns integers", "[VarInt]") {
     const auto PositiveValue = 34;
@@ -62,3 +68,148 @@ TEST_CASE("VarInt serializes and deserializes correctly", "[VarInt]") {
         REQUIRE(result.GetInt() == 0);
     }
 }
+
+TEST_CASE("TryReadVarInt reports partial and malformed data", "[VarInt]") {
+    s32 value = 0;
+    std::size_t length = 0;
+
+    SECTION("complete data decodes") {
+        const u8 data[] = { 0xAC, 0x02, 0xFF };
+
+        REQUIRE(mc::TryReadVarInt(data, sizeof(data), value, length) == mc::DecodeResult::Success);
+        REQUIRE(value == 300);
+        REQUIRE(length == 2);
+    }
+
+    SECTION("partially received data needs more") {
+        const u8 data[] = { 0xAC, 0x82 };
+
+        REQUIRE(mc::TryReadVarInt(data, sizeof(data), value, length) == mc::DecodeResult::Incomplete);
+        REQUIRE(mc::TryReadVarInt(data, 0, value, length) == mc::DecodeResult::Incomplete);
+    }
+
+    SECTION("overlong data is malformed") {
+        const u8 data[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 };
+
+        REQUIRE(mc::TryReadVarInt(data, sizeof(data), value, length) == mc::DecodeResult::Malformed);
+    }
+}
+
+TEST_CASE("VarInt codec round trips every length", "[VarInt]") {
+    const s64 values[] = { 0, 1, 127, 128, 300, 16383, 16384, 2097151, 2097152, 268435455, 268435456,
+        std::numeric_limits<s32>::max(), -1, -42, std::numeric_limits<s64>::max(), std::numeric_limits<s64>::min() };
+
+    for (s64 value : values) {
+        // Padding after the VarInt lets the 8 byte decoder run too.
+        u8 data[16] = {};
+        std::size_t written = mc::WriteVarInt(data, value);
+
+        REQUIRE(written == mc::VarInt::GetSerializedLength(value));
+
+        s64 fast = 0;
+        s64 exact = 0;
+        std::size_t fastLength = 0;
+        std::size_t exactLength = 0;
+
+        REQUIRE(mc::TryReadVarInt(data, sizeof(data), fast, fastLength) == mc::DecodeResult::Success);
+        REQUIRE(mc::TryReadVarInt(data, written, exact, exactLength) == mc::DecodeResult::Success);
+
+        REQUIRE(fast == value);
+        REQUIRE(exact == value);
+        REQUIRE(fastLength == written);
+        REQUIRE(exactLength == written);
+    }
+}
+
+TEST_CASE("ReadVarInts decodes consecutive VarInts", "[VarInt]") {
+    mc::DataBuffer buffer;
+    buffer << mc::VarInt(1) << mc::VarInt(300) << mc::VarInt(70000) << mc::VarInt(5);
+
+    s32 values[4];
+    mc::ReadVarInts(buffer, values, 4);
+
+    REQUIRE(values[0] == 1);
+    REQUIRE(values[1] == 300);
+    REQUIRE(values[2] == 70000);
+    REQUIRE(values[3] == 5);
+    REQUIRE(buffer.IsFinished());
+
+    mc::DataBuffer partial;
+    partial << mc::VarInt(1);
+
+    REQUIRE_THROWS_AS(mc::ReadVarInts(partial, values, 2), std::out_of_range);
+    REQUIRE(partial.GetReadOffset() == 0);
+}
+
+namespace {
+
+// The codec as it was before the length function and the 8 byte decoder were added.
+std::size_t ReferenceLength(s64 value) {
+    mc::DataBuffer buffer;
+    u64 uval = value;
+    char data[10];
+    int encoded = 0;
+
+    do {
+        u8 nextByte = uval & 0x7F;
+        uval >>= 7;
+        if (uval)
+            nextByte |= 0x80;
+        data[encoded++] = nextByte;
+    } while (uval);
+    buffer << std::string(data, encoded);
+
+    return buffer.GetSize();
+}
+
+std::size_t ReferenceRead(const u8* data, s64& value) {
+    u64 result = 0;
+    int shift = 0;
+    std::size_t i = 0;
+
+    do {
+        result |= (u64)(data[i] & 0x7F) << shift;
+        shift += 7;
+    } while ((data[i++] & 0x80) != 0);
+
+    value = (s64)result;
+    return i;
+}
+
+} // ns
+
+TEST_CASE("VarInt codec matches the reference codec", "[VarInt]") {
+    const std::size_t Count = 1 << 16;
+
+    std::vector<s32> values(Count);
+    u32 seed = 12345;
+    for (s32& value : values) {
+        seed = seed * 1103515245 + 12345;
+        // Block state ids like in chunk palettes, which are a mix of two and three byte VarInts.
+        value = (s32)((seed >> 16) & 0x7FFF);
+    }
+
+    std::vector<u8> encoded(Count * 5 + 8);
+    std::size_t size = 0;
+    for (s32 value : values) {
+        REQUIRE(mc::VarInt::GetSerializedLength(value) == ReferenceLength(value));
+        size += mc::WriteVarInt(&encoded[size], value);
+    }
+
+    std::vector<s32> reference(Count);
+    std::size_t referenceOffset = 0;
+    for (std::size_t i = 0; i < Count; ++i) {
+        s64 value;
+        referenceOffset += ReferenceRead(&encoded[referenceOffset], value);
+        reference[i] = (s32)value;
+    }
+
+    std::vector<s32> decoded(Count);
+    std::size_t offset = 0;
+    mc::TryReadVarInts(&encoded[0], encoded.size(), &decoded[0], Count, offset);
+
+    REQUIRE(referenceOffset == size);
+    REQUIRE(offset == size);
+    REQUIRE(reference == values);
+    REQUIRE(decoded == values);
+}
@@ -0,0 +1,202 @@
+#include "catch.hpp"
+#include "WorldHelpers.h"
+
+#include <mclib/world/World.h>
+
+#include <iterator>
+#include <map>
+#include <set>
+#include <vector>
+
+using helpers::Dirt;
+using helpers::GetPatternState;
+
+TEST_CASE("World visits the blocks of a region section by section", "[World]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    fixture.LoadColumn(helpers::CreatePatternColumn(-1));
+    fixture.LoadColumn(helpers::CreatePatternColumn(0));
+
+    std::size_t sections = 0;
+    world.ForEachSection(mc::Vector3i(-40, -10, -40), mc::Vector3i(40, 300, 40), [&](const mc::world::Chunk&, mc::Vector3i origin) {
+        // Section 1 isn't sent and the unloaded columns are skipped.
+        REQUIRE((origin.y == 0 || origin.y == 32));
+        REQUIRE(origin.z == 0);
+        ++sections;
+    });
+    REQUIRE(sections == 4);
+
+    // The range visits the same sections, column by column and bottom to top.
+    std::vector<mc::Vector3i> origins;
+    for (const mc::world::SectionRange::Entry& entry : world.GetSections(mc::Vector3i(-40, -10, -40), mc::Vector3i(40, 300, 40))) {
+        REQUIRE(&entry.section == (*world.GetChunk(entry.origin))[(std::size_t)(entry.origin.y / 16)].get());
+        origins.push_back(entry.origin);
+    }
+
+    const std::vector<mc::Vector3i> expectedOrigins = {
+        mc::Vector3i(-16, 0, 0), mc::Vector3i(-16, 32, 0), mc::Vector3i(0, 0, 0), mc::Vector3i(0, 32, 0)
+    };
+    REQUIRE(origins == expectedOrigins);
+
+    // Empty boxes and boxes outside of the world height have no sections.
+    mc::world::SectionRange empty = world.GetSections(mc::Vector3i(0, 0, 0), mc::Vector3i(16, 0, 16));
+    REQUIRE(empty.begin() == empty.end());
+    mc::world::SectionRange above = world.GetSections(mc::Vector3i(0, 256, 0), mc::Vector3i(16, 300, 16));
+    REQUIRE(above.begin() == above.end());
+
+    // Only section 2 of column 0.
+    mc::world::SectionRange single = world.GetSections(mc::Vector3i(5, 40, 5), mc::Vector3i(6, 41, 6));
+    REQUIRE(std::distance(single.begin(), single.end()) == 1);
+    REQUIRE((*single.begin()).origin == mc::Vector3i(0, 32, 0));
+
+    const mc::Vector3i min(-19, -2, -3);
+    const mc::Vector3i max(19, 52, 19);
+    std::map<mc::Vector3i, u32> visited;
+
+    world.ForEachBlock(min, max, [&](mc::Vector3i position, u32 stateId) {
+        REQUIRE(visited.emplace(position, stateId).second);
+    });
+
+    std::size_t expectedCount = 0;
+    for (s64 y = min.y; y < max.y; ++y) {
+        for (s64 z = min.z; z < max.z; ++z) {
+            for (s64 x = min.x; x < max.x; ++x) {
+                u32 expected = GetPatternState(x, y, z);
+                if (expected == 0) continue;
+
+                auto iter = visited.find(mc::Vector3i(x, y, z));
+                REQUIRE(iter != visited.end());
+                REQUIRE(iter->second == expected);
+                ++expectedCount;
+            }
+        }
+    }
+    REQUIRE(visited.size() == expectedCount);
+
+    // The box covers the blocks from its floored min to its ceiled max.
+    const mc::AABB bounds(mc::Vector3d(-0.5, 0.5, 0.5), mc::Vector3d(0.5, 1.0, 1.5));
+    std::size_t expectedInBounds = 0;
+    for (s64 z = 0; z < 2; ++z)
+        for (s64 x = -1; x < 1; ++x)
+            expectedInBounds += GetPatternState(x, 0, z) != 0;
+    REQUIRE(expectedInBounds > 0);
+
+    std::size_t inBounds = 0;
+    world.ForEachBlock(bounds, [&](mc::Vector3i position, u32 stateId) {
+        REQUIRE((position.x == -1 || position.x == 0));
+        REQUIRE(position.y == 0);
+        REQUIRE((position.z == 0 || position.z == 1));
+        REQUIRE(stateId == GetPatternState(position.x, position.y, position.z));
+        ++inBounds;
+    });
+    REQUIRE(inBounds == expectedInBounds);
+}
+
+TEST_CASE("World finds blocks through section palettes", "[World]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    fixture.LoadColumn(helpers::CreatePatternColumn(-1));
+    fixture.LoadColumn(helpers::CreatePatternColumn(0));
+
+    const u32 Gold = 14 << 4;
+    mc::world::ChunkColumnPtr column = world.GetChunk(mc::Vector3i(0, 0, 0));
+    mc::world::ChunkColumnPtr left = world.GetChunk(mc::Vector3i(-1, 0, 0));
+
+    REQUIRE(column->MayContain(Dirt));
+    REQUIRE(column->MayContain(0));
+    REQUIRE_FALSE(column->MayContain(Gold));
+    REQUIRE_FALSE(left->MayContain(Gold));
+    REQUIRE(world.FindBlocks({ Gold }, mc::Vector3i(-16, 0, 0), mc::Vector3i(16, 256, 16)).empty());
+
+    // Block changes add their states to the summary, including in sections that weren't sent.
+    fixture.ChangeBlock(mc::Vector3i(3, 40, 5), Gold);
+    REQUIRE(column->MayContain(Gold));
+    REQUIRE_FALSE(left->MayContain(Gold));
+
+    fixture.ChangeBlocks({ mc::Vector3i(-5, 2, 7), mc::Vector3i(-3, 20, 1) }, Gold);
+    REQUIRE(left->MayContain(Gold));
+
+    std::vector<mc::Vector3i> gold = world.FindBlocks({ Gold }, mc::Vector3i(-16, 0, 0), mc::Vector3i(16, 256, 16));
+    const std::set<mc::Vector3i> expectedGold = { mc::Vector3i(3, 40, 5), mc::Vector3i(-5, 2, 7), mc::Vector3i(-3, 20, 1) };
+
+    REQUIRE(gold.size() == expectedGold.size());
+    REQUIRE(std::set<mc::Vector3i>(gold.begin(), gold.end()) == expectedGold);
+
+    const mc::Vector3i min(-19, -2, -3);
+    const mc::Vector3i max(19, 52, 19);
+    std::vector<mc::Vector3i> found = world.FindBlocks({ Dirt, Gold }, min, max);
+    std::set<mc::Vector3i> positions(found.begin(), found.end());
+
+    REQUIRE(positions.size() == found.size());
+
+    std::size_t expectedCount = 0;
+    for (s64 y = min.y; y < max.y; ++y) {
+        for (s64 z = min.z; z < max.z; ++z) {
+            for (s64 x = min.x; x < max.x; ++x) {
+                const mc::Vector3i position(x, y, z);
+
+                if (expectedGold.count(position) == 0 && GetPatternState(x, y, z) != Dirt) continue;
+
+                REQUIRE(positions.count(position) == 1);
+                ++expectedCount;
+            }
+        }
+    }
+    REQUIRE(found.size() == expectedCount);
+
+    // Air in the sections that weren't sent is found too.
+    std::vector<mc::Vector3i> air = world.FindBlocks({ 0 }, mc::AABB(mc::Vector3d(0, 16, 0), mc::Vector3d(2, 18, 1)));
+    REQUIRE(air.size() == 4);
+}
+
+TEST_CASE("World rare block search matches a full scan", "[World]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    for (s32 x = -8; x < 8; ++x)
+        fixture.LoadColumn(helpers::CreatePatternColumn(x));
+
+    const mc::Vector3i min(-128, 0, 0);
+    const mc::Vector3i max(128, 256, 16);
+    const u32 Gold = 14 << 4;
+    std::size_t reference = 0;
+
+    // A few gold blocks in two of the columns, so most columns can be skipped but the rest still have to be searched.
+    fixture.ChangeBlock(mc::Vector3i(-100, 40, 3), Gold);
+    fixture.ChangeBlock(mc::Vector3i(37, 5, 12), Gold);
+    fixture.ChangeBlock(mc::Vector3i(40, 80, 0), Gold);
+
+    world.ForEachBlock(min, max, [&](mc::Vector3i, u32 stateId) {
+        reference += stateId == Gold;
+    });
+
+    REQUIRE(reference == 3);
+    REQUIRE(world.FindBlocks({ Gold }, min, max).size() == reference);
+}
+
+TEST_CASE("World region scan matches GetBlock", "[World]") {
+    helpers::WorldFixture fixture;
+    mc::world::World& world = fixture.world;
+
+    for (s32 x = -8; x < 8; ++x)
+        fixture.LoadColumn(helpers::CreatePatternColumn(x));
+
+    const mc::Vector3i min(-128, 0, 0);
+    const mc::Vector3i max(128, 256, 16);
+    std::size_t reference = 0;
+    std::size_t scanned = 0;
+
+    for (s64 y = min.y; y < max.y; ++y)
+        for (s64 z = min.z; z < max.z; ++z)
+            for (s64 x = min.x; x < max.x; ++x)
+                reference += world.GetBlock(mc::Vector3i(x, y, z))->GetType() == Dirt;
+
+    world.ForEachBlock(min, max, [&](mc::Vector3i, u32 stateId) {
+        scanned += stateId == Dirt;
+    });
+
+    REQUIRE(reference > 0);
+    REQUIRE(scanned == reference);
+}
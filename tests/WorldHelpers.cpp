@@ -0,0 +1,191 @@
+#include "WorldHelpers.h"
+
+#include "catch.hpp"
+
+#include <mclib/common/Position.h>
+#include <mclib/common/VarInt.h>
+
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace helpers {
+
+namespace {
+
+// Serializes one section in the format of the version.
+void WriteSection(mc::DataBuffer& out, const ColumnData& column, s32 section, mc::protocol::Version version) {
+    const bool aligned = version > mc::protocol::Version::Minecraft_1_15_2;
+    std::vector<u32> palette;
+    std::map<u32, u64> paletteIndex;
+    std::vector<u64> entries(4096);
+    u16 blockCount = 0;
+
+    for (s32 i = 0; i < 4096; ++i) {
+        const u32 state = column.state(i & 15, section * 16 + (i >> 8), (i >> 4) & 15);
+
+        auto iter = paletteIndex.emplace(state, palette.size()).first;
+        if (iter->second == palette.size())
+            palette.push_back(state);
+
+        entries[i] = iter->second;
+        blockCount += state != 0;
+    }
+
+    if (palette.size() > 256)
+        throw std::runtime_error("Test sections can't use the global palette.");
+
+    u8 bits = 4;
+    while (palette.size() > (1u << bits))
+        ++bits;
+
+    const std::size_t perLong = 64 / bits;
+    std::vector<u64> data(aligned ? (4096 + perLong - 1) / perLong : 4096 * bits / 64, 0);
+
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (aligned) {
+            data[i / perLong] |= entries[i] << ((i % perLong) * bits);
+        } else {
+            const std::size_t bit = i * bits;
+
+            data[bit / 64] |= entries[i] << (bit % 64);
+            if (bit % 64 + bits > 64)
+                data[bit / 64 + 1] |= entries[i] >> (64 - bit % 64);
+        }
+    }
+
+    if (version >= mc::protocol::Version::Minecraft_1_14_2)
+        out << blockCount;
+
+    out << bits << mc::VarInt((s32)palette.size());
+    for (u32 state : palette)
+        out << mc::VarInt((s32)state);
+
+    out << mc::VarInt((s32)data.size());
+    for (u64 value : data)
+        out << value;
+
+    if (version > mc::protocol::Version::Minecraft_1_13_2) return;
+
+    const LightFunc* lights[] = { &column.blockLight, &column.skyLight };
+    for (const LightFunc* light : lights) {
+        for (s32 i = 0; i < 4096; i += 2) {
+            const s32 y = section * 16 + (i >> 8);
+            const s32 z = (i >> 4) & 15;
+
+            out << (u8)((*light)(i & 15, y, z) | ((*light)((i & 15) + 1, y, z) << 4));
+        }
+    }
+}
+
+} // ns
+
+ColumnData::ColumnData(s32 x, s32 z, u16 sectionMask, StateFunc state)
+    : x(x), z(z), sectionMask(sectionMask), state(std::move(state)),
+      skyLight([](s32, s32, s32) { return (u8)15; }),
+      blockLight([](s32, s32, s32) { return (u8)0; })
+{
+}
+
+mc::DataBuffer CreateChunkData(const ColumnData& column, mc::protocol::Version version) {
+    if (version != mc::protocol::Version::Minecraft_1_12_2 && version != mc::protocol::Version::Minecraft_1_16_5)
+        throw std::runtime_error("Test chunk data is only written for 1.12.2 and 1.16.5.");
+
+    const bool legacy = version == mc::protocol::Version::Minecraft_1_12_2;
+
+    mc::DataBuffer sections;
+    for (s32 section = 0; section < 16; ++section) {
+        if (column.sectionMask & (1 << section))
+            WriteSection(sections, column, section, version);
+    }
+
+    mc::DataBuffer buffer;
+    buffer << column.x << column.z << true << mc::VarInt(column.sectionMask);
+
+    if (legacy) {
+        buffer << mc::VarInt((s32)(sections.GetSize() + 256));
+        buffer << sections;
+        // Biomes
+        for (s32 i = 0; i < 256; ++i)
+            buffer << (u8)0;
+    } else {
+        buffer << column.heightmaps;
+        // Biomes
+        buffer << mc::VarInt(1024);
+        for (s32 i = 0; i < 1024; ++i)
+            buffer << mc::VarInt(0);
+        buffer << mc::VarInt((s32)sections.GetSize());
+        buffer << sections;
+    }
+
+    // Block entities
+    buffer << mc::VarInt(0);
+    return buffer;
+}
+
+void ReadChunkData(const ColumnData& column, mc::protocol::Version version, mc::protocol::packets::in::ChunkDataPacket& packet) {
+    mc::DataBuffer buffer = CreateChunkData(column, version);
+
+    packet.SetProtocolVersion(version);
+    REQUIRE(packet.Deserialize(buffer, buffer.GetSize()));
+    REQUIRE(buffer.IsFinished());
+}
+
+u32 GetPatternState(s64 x, s64 y, s64 z) {
+    const u32 palette[] = { 0, Stone, Dirt };
+
+    if (x < -16 || x >= 16 || z < 0 || z >= 16 || y < 0 || y >= 48 || (y >> 4) == 1) return 0;
+
+    return palette[(u32)((x & 15) * 3 + y * 5 + z * 7 + (x < 0 ? 1 : 0)) % 3];
+}
+
+ColumnData CreatePatternColumn(s32 chunkX) {
+    return ColumnData(chunkX, 0, (1 << 0) | (1 << 2), [chunkX](s32 x, s32 y, s32 z) {
+        return GetPatternState(chunkX * 16 + x, y, z);
+    });
+}
+
+WorldFixture::WorldFixture(mc::protocol::Version version)
+    : m_Version(version), world(&m_Dispatcher)
+{
+    mc::block::BlockRegistry* registry = mc::block::BlockRegistry::GetInstance();
+
+    registry->ClearRegistry();
+    registry->RegisterVanillaBlocks(version);
+}
+
+void WorldFixture::LoadColumn(const ColumnData& column) {
+    mc::protocol::packets::in::ChunkDataPacket packet;
+
+    ReadChunkData(column, m_Version, packet);
+    world.HandlePacket(&packet);
+}
+
+void WorldFixture::ChangeBlock(mc::Vector3i position, u32 stateId) {
+    mc::DataBuffer buffer;
+    buffer << mc::Position((s32)position.x, (s32)position.y, (s32)position.z, m_Version) << mc::VarInt((s32)stateId);
+
+    mc::protocol::packets::in::BlockChangePacket packet;
+    packet.SetProtocolVersion(m_Version);
+    REQUIRE(packet.Deserialize(buffer, buffer.GetSize()));
+
+    world.HandlePacket(&packet);
+}
+
+void WorldFixture::ChangeBlocks(const std::vector<mc::Vector3i>& positions, u32 stateId) {
+    if (m_Version != mc::protocol::Version::Minecraft_1_12_2)
+        throw std::runtime_error("Test multi block changes are only written for 1.12.2.");
+
+    mc::DataBuffer buffer;
+    buffer << (s32)(positions[0].x >> 4) << (s32)(positions[0].z >> 4) << mc::VarInt((s32)positions.size());
+    for (mc::Vector3i position : positions)
+        buffer << (u8)(((position.x & 15) << 4) | (position.z & 15)) << (u8)position.y << mc::VarInt((s32)stateId);
+
+    mc::protocol::packets::in::MultiBlockChangePacket packet;
+    packet.SetProtocolVersion(m_Version);
+    REQUIRE(packet.Deserialize(buffer, buffer.GetSize()));
+
+    world.HandlePacket(&packet);
+}
+
+} // ns helpers
@@ -0,0 +1,73 @@
+#ifndef MCLIB_TESTS_WORLD_HELPERS_H_
+#define MCLIB_TESTS_WORLD_HELPERS_H_
+
+#include <mclib/common/DataBuffer.h>
+#include <mclib/nbt/NBT.h>
+#include <mclib/protocol/packets/Packet.h>
+#include <mclib/protocol/packets/PacketDispatcher.h>
+#include <mclib/world/World.h>
+
+#include <functional>
+#include <vector>
+
+namespace helpers {
+
+const u32 Stone = 1 << 4;
+const u32 Dirt = 3 << 4;
+
+typedef std::function<u32(s32 x, s32 y, s32 z)> StateFunc;
+typedef std::function<u8(s32 x, s32 y, s32 z)> LightFunc;
+
+/**
+ * Contents of a chunk column for CreateChunkData.
+ * The callbacks get positions relative to the column, with y going from 0 to 255.
+ */
+struct ColumnData {
+    s32 x;
+    s32 z;
+    u16 sectionMask;
+    StateFunc state;
+    // Only sent in the chunk data up to 1.13.2. Sky light defaults to 15 and block light to 0.
+    LightFunc skyLight;
+    LightFunc blockLight;
+    // Only sent since 1.14.
+    mc::nbt::NBT heightmaps;
+
+    ColumnData(s32 x, s32 z, u16 sectionMask, StateFunc state);
+};
+
+// Serializes the chunk data of a full column for 1.12.2 or 1.16.5. Sections can use up to 256 different states.
+mc::DataBuffer CreateChunkData(const ColumnData& column, mc::protocol::Version version);
+
+// Deserializes the chunk data of the column into packet.
+void ReadChunkData(const ColumnData& column, mc::protocol::Version version, mc::protocol::packets::in::ChunkDataPacket& packet);
+
+/**
+ * The blocks of the pattern columns at chunk -1, 0 and 0, 0. Only sections 0 and 2 are sent,
+ * filled with a mix of air, stone and dirt. Everywhere else is air.
+ */
+u32 GetPatternState(s64 x, s64 y, s64 z);
+ColumnData CreatePatternColumn(s32 chunkX);
+
+/**
+ * A world with the vanilla blocks of a version registered.
+ */
+class WorldFixture {
+private:
+    mc::protocol::Version m_Version;
+    mc::protocol::packets::PacketDispatcher m_Dispatcher;
+
+public:
+    mc::world::World world;
+
+    explicit WorldFixture(mc::protocol::Version version = mc::protocol::Version::Minecraft_1_12_2);
+
+    void LoadColumn(const ColumnData& column);
+    void ChangeBlock(mc::Vector3i position, u32 stateId);
+    // Sends one multi block change for positions in the same column. Only written for 1.12.2.
+    void ChangeBlocks(const std::vector<mc::Vector3i>& positions, u32 stateId);
+};
+
+} // ns helpers
+
+#endif